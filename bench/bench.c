@@ -0,0 +1,675 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "hash_utils.h"
+#include "attack.h"
+#include "targets.h"
+#include "markov.h"
+#include "chain.h"
+#include "utils.h"
+
+// Microbenchmarks of the hot components and end-to-end runs of each attack mode
+// Results are written as JSON and compared against a stored baseline
+
+#define BENCH_WARMUP_TIME 0.1     // Untimed run of each benchmark before the rounds, in seconds
+#define BENCH_MIN_TIME 0.2        // Minimum measured time per round, in seconds
+#define BENCH_ROUNDS 7            // Rounds over the whole suite, each benchmark keeps its median
+#define BENCH_MAX_TOLERANCE 2.0   // Noise allowance cap, as a multiple of the regression threshold
+#define BENCH_WORDS 100000        // Words in the generated wordlist
+#define BENCH_TARGETS 100000      // Hashes in the generated hash file
+#define BENCH_LEFT_WORDS 200      // Left wordlist of the combinator, base words of the hybrid run
+#define BENCH_RIGHT_WORDS 1000    // Right wordlist of the combinator
+#define BENCH_MAX_BENCHMARKS 64
+#define BENCH_STRIDE 16           // Candidate slot in the packed batch (generated words are at most 12 characters)
+#define BENCH_BATCH 1024          // Candidates per hash_batch call
+#define BENCH_NAME_LENGTH 64
+
+// Benchmark body: performs some work and returns the number of operations done
+typedef size_t (*BenchFunc_t)(const void *context);
+
+typedef struct
+{
+    char name[BENCH_NAME_LENGTH];
+    BenchFunc_t run;
+    const void *context;
+    double rates[BENCH_ROUNDS];     // Throughput of each round
+    double ops_per_sec;             // Median over the rounds
+    double noise;                   // Spread of the middle rounds, in percent of the median
+} Bench_t;
+
+static Bench_t benchmarks[BENCH_MAX_BENCHMARKS];
+static size_t bench_count = 0;
+
+// Keeps the compiler from discarding benchmarked work
+static volatile unsigned long bench_sink;
+
+// Generated inputs
+static char wordlist_path[256];
+static char hashfile_path[256];
+static char left_path[256];
+static char right_path[256];
+static WordList_t words;
+static unsigned char *packed_words;   // The wordlist at a fixed stride, as hash_batch takes it
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Deterministic word generator (LCG), so every run hashes the same candidates
+static uint32_t lcg_state;
+
+static uint32_t lcg_next(void)
+{
+    lcg_state = lcg_state * 1664525U + 1013904223U;
+    return lcg_state >> 8;
+}
+
+static void generate_word(char *word)
+{
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    size_t length = 6 + lcg_next() % 7;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        word[i] = alphabet[lcg_next() % (sizeof(alphabet) - 1)];
+    }
+    word[length] = '\0';
+}
+
+static bool write_wordlist(const char *path, size_t count, uint32_t seed)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    char word[16];
+    lcg_state = seed;
+    for (size_t i = 0; i < count; i++)
+    {
+        generate_word(word);
+        fprintf(file, "%s\n", word);
+    }
+
+    fclose(file);
+    return true;
+}
+
+// Hash file of MD5 digests of words that are not in the wordlist
+static bool write_hashfile(const char *path, size_t count)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    char word[20];
+    unsigned char digest[MD5_DIGEST_LENGTH];
+    char hex[MD5_DIGEST_LENGTH * 2 + 1];
+    lcg_state = 0xfeedU;
+    for (size_t i = 0; i < count; i++)
+    {
+        word[0] = '#';
+        generate_word(word + 1);
+        MD5((const unsigned char *)word, strlen(word), digest);
+        hash_to_hex(digest, MD5_DIGEST_LENGTH, hex);
+        fprintf(file, "%s\n", hex);
+    }
+
+    fclose(file);
+    return true;
+}
+
+static void add_bench(const char *name, BenchFunc_t run, const void *context)
+{
+    if (bench_count == BENCH_MAX_BENCHMARKS)
+    {
+        return;
+    }
+
+    Bench_t *bench = &benchmarks[bench_count++];
+    snprintf(bench->name, sizeof(bench->name), "%s", name);
+    bench->run = run;
+    bench->context = context;
+}
+
+// Silence stdout while the cracking functions print their results
+static int silence_stdout(void)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0)
+    {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+    return saved;
+}
+
+static void restore_stdout(int saved)
+{
+    fflush(stdout);
+    if (saved >= 0)
+    {
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+}
+
+// Repeat the benchmark for at least 'seconds' and return its throughput
+static double measure(const Bench_t *bench, double seconds)
+{
+    double ops = 0;
+    double start = now();
+    double elapsed;
+
+    do
+    {
+        ops += (double)bench->run(bench->context);
+        elapsed = now() - start;
+    } while (elapsed < seconds);
+
+    return ops / elapsed;
+}
+
+// Warm every benchmark up, then measure the whole suite BENCH_ROUNDS times
+// Interleaving the rounds spreads each benchmark's samples over the whole run, so a burst
+// of load on the machine costs one sample of several benchmarks rather than a whole benchmark
+static void run_suite(void)
+{
+    for (size_t i = 0; i < bench_count; i++)
+    {
+        measure(&benchmarks[i], BENCH_WARMUP_TIME);
+    }
+
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        printf("  round %d/%d\n", round + 1, BENCH_ROUNDS);
+        fflush(stdout);
+
+        for (size_t i = 0; i < bench_count; i++)
+        {
+            benchmarks[i].rates[round] = measure(&benchmarks[i], BENCH_MIN_TIME);
+        }
+    }
+
+    for (size_t i = 0; i < bench_count; i++)
+    {
+        Bench_t *bench = &benchmarks[i];
+        double sorted[BENCH_ROUNDS];
+
+        // Insertion sort of the rounds
+        for (int j = 0; j < BENCH_ROUNDS; j++)
+        {
+            int k = j;
+            while (k > 0 && sorted[k - 1] > bench->rates[j])
+            {
+                sorted[k] = sorted[k - 1];
+                k--;
+            }
+            sorted[k] = bench->rates[j];
+        }
+
+        // The fastest and slowest rounds are left out of the noise floor
+        bench->ops_per_sec = sorted[BENCH_ROUNDS / 2];
+        bench->noise = (sorted[BENCH_ROUNDS - 2] - sorted[1]) / bench->ops_per_sec * 100.0;
+        printf("  %-28s %14.0f ops/s  (noise %4.1f%%)\n", bench->name, bench->ops_per_sec, bench->noise);
+    }
+}
+
+static size_t run_read_line(const void *context)
+{
+    (void)context;
+    FILE *file = fopen(wordlist_path, "r");
+    char buffer[MAX_LENGTH];
+    size_t count = 0;
+
+    while (read_line(file, buffer, MAX_LENGTH))
+    {
+        count++;
+    }
+
+    fclose(file);
+    bench_sink += count;
+    return count;
+}
+
+static size_t run_hash_generic(const void *context)
+{
+    (void)context;
+    char output[MD5_DIGEST_LENGTH * 2 + 1];
+
+    for (size_t i = 0; i < words.count; i++)
+    {
+        hash_generic(words.data + words.offsets[i], MD5, MD5_DIGEST_LENGTH, output);
+        bench_sink += (unsigned char)output[0];
+    }
+
+    return words.count;
+}
+
+static size_t run_hash_to_hex(const void *context)
+{
+    (void)context;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    char output[SHA256_DIGEST_LENGTH * 2 + 1];
+    size_t rounds = 10000;
+
+    for (size_t i = 0; i < rounds; i++)
+    {
+        memset(digest, (int)(i & 0xff), sizeof(digest));
+        hash_to_hex(digest, sizeof(digest), output);
+        bench_sink += (unsigned char)output[1];
+    }
+
+    return rounds;
+}
+
+// Hash the wordlist through hash_batch, i.e. the FAST_HASH_LIST kernel every attack mode calls
+static size_t run_algorithm(const void *context)
+{
+    const Hash_t *args = context;
+    static unsigned char digests[BENCH_BATCH * SHA512_DIGEST_LENGTH];
+
+    for (size_t i = 0; i < words.count; i += BENCH_BATCH)
+    {
+        size_t count = (words.count - i < BENCH_BATCH) ? words.count - i : BENCH_BATCH;
+        args->hash_batch(packed_words + i * BENCH_STRIDE, BENCH_STRIDE, words.lengths + i, count, digests);
+        bench_sink += digests[0];
+    }
+
+    return words.count;
+}
+
+static size_t run_load_hash_file(const void *context)
+{
+    (void)context;
+    TargetSet_t targets;
+    LoadStats_t stats;
+
+    if (!load_hash_file(hashfile_path, MD5_DIGEST_LENGTH, "MD5", &targets, &stats))
+    {
+        return 0;
+    }
+
+    bench_sink += targets.count;
+    free_targets(&targets);
+    return stats.total;
+}
+
+// Lookups in the loaded hash file, with the MD5 digests of the wordlist as misses
+typedef struct
+{
+    TargetSet_t targets;
+    unsigned char *misses;
+} LookupContext_t;
+
+static size_t run_target_lookup(const void *context)
+{
+    const LookupContext_t *lookup = context;
+    const TargetSet_t *targets = &lookup->targets;
+    const unsigned char *misses = lookup->misses;
+    size_t lookups = 0;
+
+    // Alternate hits (targets themselves) and misses (digests of the wordlist)
+    for (size_t i = 0; i < targets->count && i < words.count; i++)
+    {
+        bench_sink += target_lookup(targets, targets->digests + i * targets->digest_length);
+        bench_sink += target_lookup(targets, misses + i * MD5_DIGEST_LENGTH);
+        lookups += 2;
+    }
+
+    return lookups;
+}
+
+// Full wordlist pass against a hash that is not in the wordlist
+static size_t run_crack_hash(const void *context)
+{
+    const char *alg_name = context;
+    Hash_t args;
+    memset(&args, 0, sizeof(args));
+    get_alg_id(alg_name, &args);
+
+    char hash[SHA512_DIGEST_LENGTH * 2 + 1];
+    memset(hash, 'f', args.digest_length * 2);
+    hash[args.digest_length * 2] = '\0';
+
+    int saved = silence_stdout();
+    crack_hash(&args, hash, wordlist_path);
+    restore_stdout(saved);
+    return words.count;
+}
+
+static size_t run_crack_targets(const void *context)
+{
+    (void)context;
+    Hash_t args;
+    memset(&args, 0, sizeof(args));
+    get_alg_id("MD5", &args);
+
+    TargetSet_t targets;
+    LoadStats_t stats;
+    if (!load_hash_file(hashfile_path, MD5_DIGEST_LENGTH, "MD5", &targets, &stats))
+    {
+        return 0;
+    }
+
+    int saved = silence_stdout();
+    crack_targets(&args, &targets, wordlist_path);
+    restore_stdout(saved);
+    free_targets(&targets);
+    return words.count;
+}
+
+// Three legacy MD5-length schemes in one pass over the hash file, two of them sharing md5(p)
+static size_t run_chain(const void *context)
+{
+    const ChainPlan_t *plan = context;
+    TargetSet_t targets;
+    LoadStats_t stats;
+    if (!load_hash_file(hashfile_path, MD5_DIGEST_LENGTH, "MD5", &targets, &stats))
+    {
+        return 0;
+    }
+
+    int saved = silence_stdout();
+    chain_crack(plan, &targets, 1, wordlist_path);
+    restore_stdout(saved);
+    free_targets(&targets);
+    return words.count;
+}
+
+static size_t run_combinator(const void *context)
+{
+    (void)context;
+    Hash_t args;
+    memset(&args, 0, sizeof(args));
+    get_alg_id("MD5", &args);
+
+    int saved = silence_stdout();
+    crack_combinator(&args, "ffffffffffffffffffffffffffffffff", left_path, right_path);
+    restore_stdout(saved);
+    return BENCH_LEFT_WORDS * BENCH_RIGHT_WORDS;
+}
+
+static size_t run_hybrid(const void *context)
+{
+    (void)context;
+    Hash_t args;
+    memset(&args, 0, sizeof(args));
+    get_alg_id("MD5", &args);
+
+    int saved = silence_stdout();
+    crack_hybrid(&args, "ffffffffffffffffffffffffffffffff", left_path, "?d?d?d", false);
+    restore_stdout(saved);
+    return BENCH_LEFT_WORDS * 1000;
+}
+
+// Full Markov enumeration of length 3 (95^3 candidates)
+static size_t run_markov(const void *context)
+{
+    const MarkovTable_t *table = context;
+    Hash_t args;
+    memset(&args, 0, sizeof(args));
+    get_alg_id("MD5", &args);
+
+    int saved = silence_stdout();
+    crack_markov(&args, "ffffffffffffffffffffffffffffffff", table, 3, 3);
+    restore_stdout(saved);
+    return MARKOV_CHARSET * MARKOV_CHARSET * MARKOV_CHARSET;
+}
+
+static bool write_results(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    fprintf(file, "{\n  \"results\": [\n");
+    for (size_t i = 0; i < bench_count; i++)
+    {
+        fprintf(file, "    {\"name\": \"%s\", \"ops_per_sec\": %.1f, \"noise_pct\": %.1f}%s\n",
+                benchmarks[i].name, benchmarks[i].ops_per_sec, benchmarks[i].noise,
+                (i + 1 < bench_count) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    fclose(file);
+    return true;
+}
+
+// Compare against a baseline written by write_results; returns the number of regressions, or -1
+// when the baseline can't be read
+// A benchmark regresses once it drops by more than the threshold, or by more than the noise
+// measured in both runs when that is larger, up to BENCH_MAX_TOLERANCE times the threshold
+// Benchmarks whose noise exceeds that cap in either run can't be judged and are counted in 'inconclusive'
+static int compare_baseline(const char *path, double threshold, int *inconclusive)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "\nError: No baseline at '%s' (run 'make bench-baseline', or pass an empty BENCH_BASELINE to skip the check).\n", path);
+        return -1;
+    }
+
+    char line[256];
+    int regressions = 0;
+    double max_tolerance = threshold * BENCH_MAX_TOLERANCE;
+    *inconclusive = 0;
+
+    printf("\n=== Regression check (threshold %.1f%%) ===\n", threshold);
+
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[BENCH_NAME_LENGTH];
+        double baseline;
+        double baseline_noise = 0;
+
+        // Baselines written before noise_pct existed only have the throughput
+        if (sscanf(line, " {\"name\": \"%63[^\"]\", \"ops_per_sec\": %lf, \"noise_pct\": %lf",
+                   name, &baseline, &baseline_noise) < 2 || baseline <= 0)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < bench_count; i++)
+        {
+            if (strcmp(benchmarks[i].name, name) != 0)
+                continue;
+
+            double change = (benchmarks[i].ops_per_sec - baseline) / baseline * 100.0;
+            double tolerance = baseline_noise + benchmarks[i].noise;
+            if (tolerance < threshold)
+                tolerance = threshold;
+
+            if (baseline_noise > max_tolerance || benchmarks[i].noise > max_tolerance)
+            {
+                printf("  %-28s %+7.1f%% (noise %.1f%% / %.1f%%) INCONCLUSIVE, rerun\n",
+                       name, change, baseline_noise, benchmarks[i].noise);
+                (*inconclusive)++;
+                continue;
+            }
+            if (tolerance > max_tolerance)
+                tolerance = max_tolerance;
+
+            bool regressed = change < -tolerance;
+            printf("  %-28s %+7.1f%% (tolerance %4.1f%%) %s\n", name, change, tolerance, regressed ? "REGRESSION" : "ok");
+            regressions += regressed;
+        }
+    }
+
+    fclose(file);
+    return regressions;
+}
+
+static void usage(const char *program_name)
+{
+    printf("Usage : %s [-o RESULTS_JSON] [-b BASELINE_JSON] [-t THRESHOLD_PERCENT]\n", program_name);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *output_path = "bench/results.json";
+    const char *baseline_path = NULL;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output_path = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+            baseline_path = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threshold = strtod(argv[++i], NULL);
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Generate deterministic inputs
+    const char *tmp = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    long pid = (long)getpid();
+    snprintf(wordlist_path, sizeof(wordlist_path), "%s/hashcrack_bench_%ld_words.txt", tmp, pid);
+    snprintf(hashfile_path, sizeof(hashfile_path), "%s/hashcrack_bench_%ld_hashes.txt", tmp, pid);
+    snprintf(left_path, sizeof(left_path), "%s/hashcrack_bench_%ld_left.txt", tmp, pid);
+    snprintf(right_path, sizeof(right_path), "%s/hashcrack_bench_%ld_right.txt", tmp, pid);
+
+    if (!write_wordlist(wordlist_path, BENCH_WORDS, 0x1234U) ||
+        !write_hashfile(hashfile_path, BENCH_TARGETS) ||
+        !write_wordlist(left_path, BENCH_LEFT_WORDS, 0x5678U) ||
+        !write_wordlist(right_path, BENCH_RIGHT_WORDS, 0x9abcU) ||
+        !load_wordlist(wordlist_path, &words))
+    {
+        return EXIT_FAILURE;
+    }
+
+    packed_words = calloc(words.count, BENCH_STRIDE);
+    if (packed_words == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < words.count; i++)
+    {
+        memcpy(packed_words + i * BENCH_STRIDE, words.data + words.offsets[i], words.lengths[i]);
+    }
+
+    // Components
+    add_bench("read_line", run_read_line, NULL);
+    add_bench("hash_generic_md5", run_hash_generic, NULL);
+    add_bench("hash_to_hex", run_hash_to_hex, NULL);
+
+    static Hash_t algorithms[BENCH_MAX_BENCHMARKS];
+    char index[32];
+    for (size_t i = 0; i < BENCH_MAX_BENCHMARKS; i++)
+    {
+        snprintf(index, sizeof(index), "%zu", i);
+        if (get_alg_id(index, &algorithms[i]) == SIZE_MAX)
+            break;
+
+        char name[BENCH_NAME_LENGTH];
+        snprintf(name, sizeof(name), "alg_%s", algorithms[i].name);
+        add_bench(name, run_algorithm, &algorithms[i]);
+    }
+
+    add_bench("load_hash_file", run_load_hash_file, NULL);
+
+    LookupContext_t lookup = { .misses = malloc(words.count * MD5_DIGEST_LENGTH) };
+    LoadStats_t stats;
+    bool lookup_loaded = lookup.misses != NULL &&
+                         load_hash_file(hashfile_path, MD5_DIGEST_LENGTH, "MD5", &lookup.targets, &stats);
+    if (lookup_loaded)
+    {
+        for (size_t i = 0; i < words.count; i++)
+        {
+            MD5((const unsigned char *)words.data + words.offsets[i], words.lengths[i], lookup.misses + i * MD5_DIGEST_LENGTH);
+        }
+
+        add_bench("target_lookup", run_target_lookup, &lookup);
+    }
+
+    // End-to-end attack runs (no password found, so every candidate is tried)
+    add_bench("e2e_wordlist_md5", run_crack_hash, "MD5");
+    add_bench("e2e_wordlist_sha1", run_crack_hash, "SHA1");
+    add_bench("e2e_wordlist_sha256", run_crack_hash, "SHA256");
+    add_bench("e2e_wordlist_sha512", run_crack_hash, "SHA512");
+    add_bench("e2e_file_md5", run_crack_targets, NULL);
+
+    ChainPlan_t plan;
+    if (chain_compile("md5(md5(p)),md5(md5_hex(p)),md5(sha1_hex(p))", &plan))
+    {
+        add_bench("e2e_chain_md5", run_chain, &plan);
+    }
+
+    add_bench("e2e_combinator_md5", run_combinator, NULL);
+    add_bench("e2e_hybrid_md5", run_hybrid, NULL);
+
+    MarkovTable_t *table = malloc(sizeof(MarkovTable_t));
+    if (table != NULL && markov_train(wordlist_path, table))
+    {
+        add_bench("e2e_markov_md5", run_markov, table);
+    }
+
+    printf("=== HashCrack benchmarks ===\n");
+    run_suite();
+
+    if (lookup_loaded)
+    {
+        free_targets(&lookup.targets);
+    }
+    free(lookup.misses);
+    free(table);
+    free(packed_words);
+    free_wordlist(&words);
+    remove(wordlist_path);
+    remove(hashfile_path);
+    remove(left_path);
+    remove(right_path);
+
+    if (!write_results(output_path))
+    {
+        return EXIT_FAILURE;
+    }
+    printf("\nResults written to %s\n", output_path);
+
+    if (baseline_path != NULL)
+    {
+        int inconclusive;
+        int regressions = compare_baseline(baseline_path, threshold, &inconclusive);
+        if (regressions < 0)
+        {
+            return EXIT_FAILURE;
+        }
+        if (regressions > 0)
+        {
+            printf("\nThroughput regressed beyond %.1f%% of the baseline.\n", threshold);
+            return EXIT_FAILURE;
+        }
+        if (inconclusive > 0)
+        {
+            printf("\n%d benchmarks were too noisy to compare (over %.1f%%), rerun on a quieter machine.\n",
+                   inconclusive, threshold * BENCH_MAX_TOLERANCE);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+#ifndef ATTACK_H
+#define ATTACK_H
+
+#include "hash_utils.h"
+#include "fast_hash.h"
+
+// Specialized combinator loops, one per algorithm in FAST_HASH_LIST
+#define DECLARE_COMBINE_LOOP(NAME, ...) \
+    int combine_loop_##NAME(const unsigned char *target, const char *left, size_t left_length, \
+                            const WordList_t *right, char *found, size_t found_size);
+
+// Specialized hybrid loops, one per algorithm in FAST_HASH_LIST
+#define DECLARE_HYBRID_LOOP(NAME, ...) \
+    int hybrid_loop_##NAME(const HybridJob_t *job, char *found, size_t found_size);
+
+FAST_HASH_LIST(DECLARE_COMBINE_LOOP)
+FAST_HASH_LIST(DECLARE_HYBRID_LOOP)
+
+#undef DECLARE_COMBINE_LOOP
+#undef DECLARE_HYBRID_LOOP
+
+// Combinator attack: every word of the left wordlist followed by every word of the right one
+int crack_combinator(Hash_t *args, const char *hash, const char *left_path, const char *right_path);
+
+// Hybrid attack: every wordlist word followed (or preceded, with mask_first) by every mask candidate
+int crack_hybrid(Hash_t *args, const char *hash, const char *wordlist, const char *mask_string, bool mask_first);
+
+#endif // ATTACK_H
@@ -0,0 +1,60 @@
+#ifndef CHAIN_H
+#define CHAIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "targets.h"
+
+#define CHAIN_MAX_STEPS 32          // Distinct steps in a plan, shared between its expressions
+#define CHAIN_MAX_EXPRESSIONS 16    // Expressions cracked in the same pass
+#define CHAIN_MAX_TEXT 128          // Longest expression text kept for reports
+#define CHAIN_MAX_OUTPUT 128        // Longest step output (hex of a 64-byte digest)
+#define CHAIN_INPUT SIZE_MAX        // Source of a step reading the password itself
+
+// Operation of a plan step
+typedef enum
+{
+    CHAIN_HASH,                     // Digest of the source with one of the FAST_HASH_LIST kernels
+    CHAIN_HEX                       // Lowercase hexadecimal encoding of the source
+} ChainOp_t;
+
+typedef struct
+{
+    ChainOp_t op;
+    size_t function;                // Kernel index (CHAIN_HASH only)
+    size_t source;                  // Step whose output is the input, or CHAIN_INPUT
+    size_t length;                  // Output length in bytes
+} ChainStep_t;
+
+typedef struct
+{
+    char text[CHAIN_MAX_TEXT];      // Expression as written
+    size_t step;                    // Step producing the digest compared against the targets
+    size_t digest_length;
+} ChainExpression_t;
+
+// Compiled expressions: steps are in evaluation order (sources always come first),
+// and identical sub-expressions are compiled to a single step evaluated once per candidate
+typedef struct
+{
+    ChainStep_t steps[CHAIN_MAX_STEPS];
+    size_t step_count;
+    ChainExpression_t expressions[CHAIN_MAX_EXPRESSIONS];
+    size_t expression_count;
+} ChainPlan_t;
+
+// True if an algorithm argument is an expression rather than an algorithm name
+bool is_chain_expression(const char *text);
+
+// Compile comma-separated expressions such as "sha1(md5_hex(p)),md5(md5(p))" into the plan
+// Functions are the algorithm names (md5, sha256, ntlm, ...), a '_hex' suffix hex-encodes
+// the digest before it is passed on, and 'p' is the password
+// Errors are reported on stderr
+bool chain_compile(const char *text, ChainPlan_t *plan);
+
+// Crack 'set_count' target sets in a single wordlist pass, each expression being checked
+// against the set of its digest length (if any)
+size_t chain_crack(const ChainPlan_t *plan, TargetSet_t *targets, size_t set_count, const char *wordlist);
+
+#endif // CHAIN_H
@@ -4,6 +4,10 @@
 #include <stdbool.h>
 #include "hash_utils.h"
 
+// parse_args return value when standard mode arguments are validated
+// (distinct from EXIT_SUCCESS/EXIT_FAILURE returned by file mode)
+#define STANDARD_MODE_READY 2
+
 // Print usage information
 void print_usage(const char *program_name);
 // Show help message
@@ -22,4 +26,10 @@ void print_validation_error(const char *message, const char *program_name);
 bool validate_hash_file(const char *hash_file_path);
 int process_hash_file(const char *hash_file_path, const char *wordlist_path, Hash_t *args);
 
+// Attack mode processing
+int process_attack(int argc, char *argv[], int attack_index, const char *program_name);
+
+// Chained-hash expression processing
+int process_chain(int argc, char *argv[], const char *program_name);
+
 #endif // CLI_H
@@ -0,0 +1,515 @@
+#ifndef FAST_HASH_H
+#define FAST_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <openssl/md5.h>
+#include <openssl/md4.h>
+#include <openssl/sha.h>
+#include <openssl/ripemd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Inlined hash kernels used by the specialized crack loops.
+// Candidates that fit in a single compression block (the common case for
+// passwords) are padded in place and fed straight to the block transform,
+// skipping the init/update/final machinery of the one-shot functions.
+// Longer inputs fall back to the OpenSSL one-shot functions.
+
+#define FAST_BLOCK_SIZE 64          // Block size of MD4/MD5/RIPEMD160/SHA1/SHA2-256
+#define FAST_BLOCK_LIMIT 56         // Longest input that fits in a single 64-byte block
+#define FAST_BLOCK_SIZE_512 128     // Block size of SHA384/SHA512
+#define FAST_BLOCK_LIMIT_512 112    // Longest input that fits in a single 128-byte block
+
+static const SHA_LONG fast_sha224_iv[8] = {
+    0xc1059ed8U, 0x367cd507U, 0x3070dd17U, 0xf70e5939U,
+    0xffc00b31U, 0x68581511U, 0x64f98fa7U, 0xbefa4fa4U
+};
+
+static const SHA_LONG fast_sha256_iv[8] = {
+    0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+    0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+};
+
+static const SHA_LONG64 fast_sha384_iv[8] = {
+    0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+    0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+};
+
+static const SHA_LONG64 fast_sha512_iv[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static inline void fast_store_le32(unsigned char *out, uint32_t value)
+{
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+    out[2] = (unsigned char)(value >> 16);
+    out[3] = (unsigned char)(value >> 24);
+}
+
+static inline void fast_store_be32(unsigned char *out, uint32_t value)
+{
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+}
+
+static inline void fast_store_be64(unsigned char *out, uint64_t value)
+{
+    fast_store_be32(out, (uint32_t)(value >> 32));
+    fast_store_be32(out + 4, (uint32_t)value);
+}
+
+// Build a single padded block: message, 0x80 marker, zero fill, bit length
+// Little-endian length word (MD4, MD5, RIPEMD160)
+static inline void fast_pad_block_le(unsigned char block[FAST_BLOCK_SIZE], const unsigned char *input, size_t length)
+{
+    memcpy(block, input, length);
+    block[length] = 0x80;
+    memset(block + length + 1, 0, FAST_BLOCK_LIMIT - length - 1);
+    uint64_t bits = (uint64_t)length << 3;
+    fast_store_le32(block + 56, (uint32_t)bits);
+    fast_store_le32(block + 60, (uint32_t)(bits >> 32));
+}
+
+// Big-endian length word (SHA1, SHA224, SHA256)
+static inline void fast_pad_block_be(unsigned char block[FAST_BLOCK_SIZE], const unsigned char *input, size_t length)
+{
+    memcpy(block, input, length);
+    block[length] = 0x80;
+    memset(block + length + 1, 0, FAST_BLOCK_LIMIT - length - 1);
+    fast_store_be64(block + 56, (uint64_t)length << 3);
+}
+
+// 128-bit big-endian length word (SHA384, SHA512)
+static inline void fast_pad_block_be128(unsigned char block[FAST_BLOCK_SIZE_512], const unsigned char *input, size_t length)
+{
+    memcpy(block, input, length);
+    block[length] = 0x80;
+    memset(block + length + 1, 0, FAST_BLOCK_LIMIT_512 + 8 - length - 1);
+    fast_store_be64(block + 120, (uint64_t)length << 3);
+}
+
+static inline void fast_md5(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT)
+    {
+        MD5(input, length, digest);
+        return;
+    }
+
+    unsigned char block[FAST_BLOCK_SIZE];
+    MD5_CTX ctx;
+    ctx.A = 0x67452301U;
+    ctx.B = 0xefcdab89U;
+    ctx.C = 0x98badcfeU;
+    ctx.D = 0x10325476U;
+
+    fast_pad_block_le(block, input, length);
+    MD5_Transform(&ctx, block);
+
+    fast_store_le32(digest, ctx.A);
+    fast_store_le32(digest + 4, ctx.B);
+    fast_store_le32(digest + 8, ctx.C);
+    fast_store_le32(digest + 12, ctx.D);
+}
+
+static inline void fast_md4(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT)
+    {
+        MD4(input, length, digest);
+        return;
+    }
+
+    unsigned char block[FAST_BLOCK_SIZE];
+    MD4_CTX ctx;
+    ctx.A = 0x67452301U;
+    ctx.B = 0xefcdab89U;
+    ctx.C = 0x98badcfeU;
+    ctx.D = 0x10325476U;
+
+    fast_pad_block_le(block, input, length);
+    MD4_Transform(&ctx, block);
+
+    fast_store_le32(digest, ctx.A);
+    fast_store_le32(digest + 4, ctx.B);
+    fast_store_le32(digest + 8, ctx.C);
+    fast_store_le32(digest + 12, ctx.D);
+}
+
+static inline void fast_ripemd160(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT)
+    {
+        RIPEMD160(input, length, digest);
+        return;
+    }
+
+    unsigned char block[FAST_BLOCK_SIZE];
+    RIPEMD160_CTX ctx;
+    ctx.A = 0x67452301U;
+    ctx.B = 0xefcdab89U;
+    ctx.C = 0x98badcfeU;
+    ctx.D = 0x10325476U;
+    ctx.E = 0xc3d2e1f0U;
+
+    fast_pad_block_le(block, input, length);
+    RIPEMD160_Transform(&ctx, block);
+
+    fast_store_le32(digest, ctx.A);
+    fast_store_le32(digest + 4, ctx.B);
+    fast_store_le32(digest + 8, ctx.C);
+    fast_store_le32(digest + 12, ctx.D);
+    fast_store_le32(digest + 16, ctx.E);
+}
+
+static inline void fast_sha1(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT)
+    {
+        SHA1(input, length, digest);
+        return;
+    }
+
+    unsigned char block[FAST_BLOCK_SIZE];
+    SHA_CTX ctx;
+    ctx.h0 = 0x67452301U;
+    ctx.h1 = 0xefcdab89U;
+    ctx.h2 = 0x98badcfeU;
+    ctx.h3 = 0x10325476U;
+    ctx.h4 = 0xc3d2e1f0U;
+
+    fast_pad_block_be(block, input, length);
+    SHA1_Transform(&ctx, block);
+
+    fast_store_be32(digest, ctx.h0);
+    fast_store_be32(digest + 4, ctx.h1);
+    fast_store_be32(digest + 8, ctx.h2);
+    fast_store_be32(digest + 12, ctx.h3);
+    fast_store_be32(digest + 16, ctx.h4);
+}
+
+// Shared single-block SHA256 compression, emitting the first 'words' state words
+static inline void fast_sha256_block(const SHA_LONG iv[8], const unsigned char *input, size_t length,
+                                     unsigned char *digest, size_t words)
+{
+    unsigned char block[FAST_BLOCK_SIZE];
+    SHA256_CTX ctx;
+    memcpy(ctx.h, iv, sizeof(ctx.h));
+
+    fast_pad_block_be(block, input, length);
+    SHA256_Transform(&ctx, block);
+
+    for (size_t i = 0; i < words; i++)
+    {
+        fast_store_be32(digest + i * 4, ctx.h[i]);
+    }
+}
+
+static inline void fast_sha224(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT)
+    {
+        SHA224(input, length, digest);
+        return;
+    }
+    fast_sha256_block(fast_sha224_iv, input, length, digest, SHA224_DIGEST_LENGTH / 4);
+}
+
+static inline void fast_sha256(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT)
+    {
+        SHA256(input, length, digest);
+        return;
+    }
+    fast_sha256_block(fast_sha256_iv, input, length, digest, SHA256_DIGEST_LENGTH / 4);
+}
+
+// Shared single-block SHA512 compression, emitting the first 'words' state words
+static inline void fast_sha512_block(const SHA_LONG64 iv[8], const unsigned char *input, size_t length,
+                                     unsigned char *digest, size_t words)
+{
+    unsigned char block[FAST_BLOCK_SIZE_512];
+    SHA512_CTX ctx;
+    memcpy(ctx.h, iv, sizeof(ctx.h));
+
+    fast_pad_block_be128(block, input, length);
+    SHA512_Transform(&ctx, block);
+
+    for (size_t i = 0; i < words; i++)
+    {
+        fast_store_be64(digest + i * 8, ctx.h[i]);
+    }
+}
+
+static inline void fast_sha384(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT_512)
+    {
+        SHA384(input, length, digest);
+        return;
+    }
+    fast_sha512_block(fast_sha384_iv, input, length, digest, SHA384_DIGEST_LENGTH / 8);
+}
+
+static inline void fast_sha512(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT_512)
+    {
+        SHA512(input, length, digest);
+        return;
+    }
+    fast_sha512_block(fast_sha512_iv, input, length, digest, SHA512_DIGEST_LENGTH / 8);
+}
+
+static inline void fast_md5_sha1(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    unsigned char md5_digest[MD5_DIGEST_LENGTH];
+    fast_md5(input, length, md5_digest);
+    fast_sha1(md5_digest, MD5_DIGEST_LENGTH, digest);
+}
+
+static inline void fast_sha256_192(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    if (length >= FAST_BLOCK_LIMIT)
+    {
+        unsigned char full_digest[SHA256_DIGEST_LENGTH];
+        SHA256(input, length, full_digest);
+        memcpy(digest, full_digest, 24);
+        return;
+    }
+    fast_sha256_block(fast_sha256_iv, input, length, digest, 24 / 4);
+}
+
+// NTLM: MD4 over the UTF-16LE encoding of the password
+
+#define FAST_WIDE_CHUNK 256 // UTF-16LE bytes produced per chunk when widening long or non-ASCII input
+
+// True if every byte is 7-bit ASCII
+static inline bool fast_is_ascii(const unsigned char *input, size_t length)
+{
+    size_t i = 0;
+    unsigned char bits = 0;
+
+#if defined(__SSE2__)
+    __m128i accumulator = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        accumulator = _mm_or_si128(accumulator, _mm_loadu_si128((const __m128i *)(const void *)(input + i)));
+    }
+    if (_mm_movemask_epi8(accumulator) != 0)
+    {
+        return false;
+    }
+#endif
+
+    for (; i < length; i++)
+    {
+        bits |= input[i];
+    }
+
+    return bits < 0x80;
+}
+
+// Widen ASCII to UTF-16LE by interleaving zero bytes (output holds 2 * length bytes)
+static inline void fast_widen_ascii(const unsigned char *input, size_t length, unsigned char *output)
+{
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(const void *)(input + i));
+        _mm_storeu_si128((__m128i *)(void *)(output + i * 2), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128((__m128i *)(void *)(output + i * 2 + 16), _mm_unpackhi_epi8(bytes, zero));
+    }
+#endif
+
+    for (; i < length; i++)
+    {
+        output[i * 2] = input[i];
+        output[i * 2 + 1] = 0;
+    }
+}
+
+static inline size_t fast_store_utf16le(unsigned char *output, uint32_t unit)
+{
+    output[0] = (unsigned char)unit;
+    output[1] = (unsigned char)(unit >> 8);
+    return 2;
+}
+
+// Decode UTF-8 into UTF-16LE until the input ends or fewer than 4 bytes of output are left
+// Bytes that do not start a valid sequence are taken as Latin-1 code points
+// Returns the bytes written; *consumed is advanced past the decoded input
+static inline size_t fast_utf8_to_utf16le(const unsigned char *input, size_t length, size_t *consumed,
+                                          unsigned char *output, size_t capacity)
+{
+    size_t written = 0;
+    size_t i = *consumed;
+
+    while (i < length && written + 4 <= capacity)
+    {
+        unsigned char lead = input[i];
+        uint32_t code_point = lead;
+        size_t sequence = 1;
+
+        if (lead >= 0xc2 && lead <= 0xf4)
+        {
+            size_t expected = (lead >= 0xf0) ? 4 : (lead >= 0xe0) ? 3 : 2;
+            uint32_t value = lead & ((lead >= 0xf0) ? 0x07U : (lead >= 0xe0) ? 0x0fU : 0x1fU);
+            bool valid = (i + expected <= length);
+
+            for (size_t k = 1; valid && k < expected; k++)
+            {
+                valid = (input[i + k] & 0xc0) == 0x80;
+                value = (value << 6) | (input[i + k] & 0x3fU);
+            }
+
+            // Reject overlong forms, surrogates and values past U+10FFFF
+            if (valid && ((expected == 3 && (value < 0x800 || (value >= 0xd800 && value <= 0xdfff))) ||
+                          (expected == 4 && (value < 0x10000 || value > 0x10ffff))))
+            {
+                valid = false;
+            }
+
+            if (valid)
+            {
+                code_point = value;
+                sequence = expected;
+            }
+        }
+
+        if (code_point >= 0x10000)
+        {
+            code_point -= 0x10000;
+            written += fast_store_utf16le(output + written, 0xd800U | (code_point >> 10));
+            written += fast_store_utf16le(output + written, 0xdc00U | (code_point & 0x3ffU));
+        }
+        else
+        {
+            written += fast_store_utf16le(output + written, code_point);
+        }
+
+        i += sequence;
+    }
+
+    *consumed = i;
+    return written;
+}
+
+// Streaming NTLM update, matching the OpenSSL *_Update signature
+static inline int fast_ntlm_update(MD4_CTX *ctx, const void *data, size_t length)
+{
+    const unsigned char *input = data;
+    unsigned char wide[FAST_WIDE_CHUNK];
+    size_t consumed = 0;
+
+    while (consumed < length)
+    {
+        size_t written = fast_utf8_to_utf16le(input, length, &consumed, wide, sizeof(wide));
+        MD4_Update(ctx, wide, written);
+    }
+
+    return 1;
+}
+
+static inline void fast_ntlm(const unsigned char *input, size_t length, unsigned char *digest)
+{
+    // Generic path: widen chunk by chunk into MD4
+    if (length >= FAST_BLOCK_LIMIT / 2)
+    {
+        MD4_CTX ctx;
+        MD4_Init(&ctx);
+        fast_ntlm_update(&ctx, input, length);
+        MD4_Final(digest, &ctx);
+        return;
+    }
+
+    // Short password: widen or decode straight into a single MD4 block
+    // Each input byte yields at most two bytes of UTF-16LE, so the output always fits
+    unsigned char block[FAST_BLOCK_SIZE];
+    size_t wide_length;
+
+    if (fast_is_ascii(input, length))
+    {
+        fast_widen_ascii(input, length, block);
+        wide_length = length * 2;
+    }
+    else
+    {
+        size_t consumed = 0;
+        wide_length = fast_utf8_to_utf16le(input, length, &consumed, block, FAST_BLOCK_LIMIT);
+    }
+
+    MD4_CTX ctx;
+    ctx.A = 0x67452301U;
+    ctx.B = 0xefcdab89U;
+    ctx.C = 0x98badcfeU;
+    ctx.D = 0x10325476U;
+
+    block[wide_length] = 0x80;
+    memset(block + wide_length + 1, 0, FAST_BLOCK_LIMIT - wide_length - 1);
+    fast_store_le32(block + 56, (uint32_t)(wide_length << 3));
+    fast_store_le32(block + 60, 0);
+    MD4_Transform(&ctx, block);
+
+    fast_store_le32(digest, ctx.A);
+    fast_store_le32(digest + 4, ctx.B);
+    fast_store_le32(digest + 8, ctx.C);
+    fast_store_le32(digest + 12, ctx.D);
+}
+
+// Streaming finals for the composite algorithms, matching the OpenSSL *_Final signature
+static inline int fast_md5_sha1_final(unsigned char *digest, MD5_CTX *ctx)
+{
+    unsigned char md5_digest[MD5_DIGEST_LENGTH];
+    MD5_Final(md5_digest, ctx);
+    fast_sha1(md5_digest, MD5_DIGEST_LENGTH, digest);
+    return 1;
+}
+
+static inline int fast_sha256_192_final(unsigned char *digest, SHA256_CTX *ctx)
+{
+    unsigned char full_digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(full_digest, ctx);
+    memcpy(digest, full_digest, 24);
+    return 1;
+}
+
+// X-macro listing every algorithm with a specialized kernel:
+// X(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE)
+// KERNEL is the one-shot fast path, CTX/INIT/UPDATE/FINAL the streaming API
+// used when a hash state is shared between candidates.
+// Used to instantiate per-algorithm loops without function-pointer dispatch
+#define FAST_HASH_LIST(X)                                                                           \
+    X(MD4, fast_md4, MD4_DIGEST_LENGTH, MD4_CTX, MD4_Init, MD4_Update, MD4_Final, FAST_BLOCK_SIZE)   \
+    X(MD5, fast_md5, MD5_DIGEST_LENGTH, MD5_CTX, MD5_Init, MD5_Update, MD5_Final, FAST_BLOCK_SIZE)   \
+    X(RIPEMD160, fast_ripemd160, RIPEMD160_DIGEST_LENGTH, RIPEMD160_CTX,                            \
+      RIPEMD160_Init, RIPEMD160_Update, RIPEMD160_Final, FAST_BLOCK_SIZE)                           \
+    X(SHA1, fast_sha1, SHA_DIGEST_LENGTH, SHA_CTX, SHA1_Init, SHA1_Update, SHA1_Final, FAST_BLOCK_SIZE) \
+    X(SHA224, fast_sha224, SHA224_DIGEST_LENGTH, SHA256_CTX,                                        \
+      SHA224_Init, SHA224_Update, SHA224_Final, FAST_BLOCK_SIZE)                                    \
+    X(SHA256, fast_sha256, SHA256_DIGEST_LENGTH, SHA256_CTX,                                        \
+      SHA256_Init, SHA256_Update, SHA256_Final, FAST_BLOCK_SIZE)                                    \
+    X(SHA384, fast_sha384, SHA384_DIGEST_LENGTH, SHA512_CTX,                                        \
+      SHA384_Init, SHA384_Update, SHA384_Final, FAST_BLOCK_SIZE_512)                                \
+    X(SHA512, fast_sha512, SHA512_DIGEST_LENGTH, SHA512_CTX,                                        \
+      SHA512_Init, SHA512_Update, SHA512_Final, FAST_BLOCK_SIZE_512)                                \
+    X(MD5_SHA1, fast_md5_sha1, SHA_DIGEST_LENGTH, MD5_CTX,                                          \
+      MD5_Init, MD5_Update, fast_md5_sha1_final, FAST_BLOCK_SIZE)                                   \
+    X(SHA256_192, fast_sha256_192, 24, SHA256_CTX,                                                  \
+      SHA256_Init, SHA256_Update, fast_sha256_192_final, FAST_BLOCK_SIZE)                           \
+    X(NTLM, fast_ntlm, MD4_DIGEST_LENGTH, MD4_CTX, MD4_Init, fast_ntlm_update, MD4_Final, FAST_BLOCK_SIZE)
+
+#endif // FAST_HASH_H
@@ -1,11 +1,44 @@
 #ifndef HASH_UTILS_H
 #define HASH_UTILS_H
 
+#include <stdio.h>
 #include <stdbool.h>
+#include "utils.h"
+#include "mask.h"
+#include "targets.h"
 
 // Hash function pointer type
 typedef unsigned char *(*HashFunc_t) (const unsigned char *, size_t, unsigned char *);
 
+// Specialized wordlist crack loop type (wordlist, binary target digest, found buffer, found buffer size)
+typedef int (*CrackFunc_t) (FILE *, const unsigned char *, char *, size_t);
+
+// Batch hash type (candidates spaced 'stride' bytes apart, candidate lengths, count, digests packed back to back)
+typedef void (*HashBatchFunc_t) (const unsigned char *, size_t, const size_t *, size_t, unsigned char *);
+
+// Specialized multi-target crack loop type (wordlist, target set), returns the number of targets cracked
+typedef size_t (*MultiCrackFunc_t) (FILE *, TargetSet_t *);
+
+// Specialized combinator loop type (binary target digest, left word, left word length,
+// right wordlist, found buffer, found buffer size)
+typedef int (*CombineFunc_t) (const unsigned char *, const char *, size_t, const WordList_t *, char *, size_t);
+
+// Slice of a hybrid attack: one base word expanded over a range of mask indexes
+typedef struct
+{
+    const unsigned char *target;    // Binary target digest
+    const Mask_t *mask;             // Parsed mask
+    const char *word;               // Base word
+    size_t word_length;             // Base word length
+    bool mask_first;                // Mask placed before the word instead of after
+    uint64_t start;                 // First mask index to try
+    uint64_t end;                   // One past the last mask index to try
+    int *stop;                      // Set once any worker found the password (see stop_requested)
+} HybridJob_t;
+
+// Specialized hybrid loop type (job, found buffer, found buffer size)
+typedef int (*HybridFunc_t) (const HybridJob_t *, char *, size_t);
+
 // Structure representing a hash algorithm and its properties
 typedef struct
 {
@@ -14,10 +47,16 @@ typedef struct
     size_t id;                  // Algorithm ID
     size_t digest_length;       // Digest length in bytes
     HashFunc_t alg;             // Hash function pointer
+    CrackFunc_t crack;          // Specialized crack loop (NULL to use the generic loop)
+    MultiCrackFunc_t crack_multi; // Specialized multi-target crack loop (NULL to use the generic loop)
+    CombineFunc_t combine;      // Specialized combinator loop (NULL to use the generic loop)
+    HybridFunc_t hybrid;        // Specialized hybrid loop (NULL to use the generic loop)
+    HashBatchFunc_t hash_batch; // Specialized batch hash (NULL to hash through alg)
 } Hash_t;
 
 void hash_to_hex(const unsigned char digest[], size_t digest_length, char *output);
 char *hash_generic(const char *input, HashFunc_t hash_alg, size_t digest_length, char *output);
+bool hex_to_digest(const char *hex, unsigned char *digest, size_t digest_length);
 
 size_t get_alg_id(const char *input, Hash_t *args);
 
@@ -26,5 +65,6 @@ void list_algorithms();
 int set_args(Hash_t *alg, Hash_t *args);
 
 int crack_hash(Hash_t *args, const char *hash, const char *wordlist);
+size_t crack_targets(Hash_t *args, TargetSet_t *targets, const char *wordlist);
 
 #endif // HASH_UTILS_H
\ No newline at end of file
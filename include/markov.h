@@ -0,0 +1,29 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "hash_utils.h"
+
+#define MARKOV_MAX_LENGTH 16    // Longest candidate generated in Markov mode
+#define MARKOV_CHARSET 95       // Printable ASCII (0x20 to 0x7e)
+#define MARKOV_START MARKOV_CHARSET // Previous-character state of the first position
+#define MARKOV_LEVELS 16        // Costs are quantized to 0..MARKOV_LEVELS-1
+
+// Per-position character transition statistics, as quantized costs (about -log2 of the probability)
+// A candidate's cost is its length cost plus the cost of each transition; lower is more likely
+typedef struct
+{
+    uint8_t length_cost[MARKOV_MAX_LENGTH + 1];
+    uint8_t cost[MARKOV_MAX_LENGTH][MARKOV_CHARSET + 1][MARKOV_CHARSET];   // [position][previous][next]
+    uint8_t order[MARKOV_MAX_LENGTH][MARKOV_CHARSET + 1][MARKOV_CHARSET];  // Next characters by increasing cost
+} MarkovTable_t;
+
+// Train the table from a wordlist (words with non-printable characters are skipped)
+bool markov_train(const char *wordlist, MarkovTable_t *table);
+
+// Markov attack: candidates of min_length..max_length in increasing cost order
+int crack_markov(Hash_t *args, const char *hash, const MarkovTable_t *table, size_t min_length, size_t max_length);
+
+#endif // MARKOV_H
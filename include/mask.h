@@ -0,0 +1,47 @@
+#ifndef MASK_H
+#define MASK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAX_MASK_LENGTH 32  // Maximum number of positions in a mask
+#define MAX_CHARSET_SIZE 96 // Largest built-in charset (?a) plus terminator
+
+// Parsed mask: one charset per position
+// Placeholders: ?l lowercase, ?u uppercase, ?d digits, ?s symbols, ?a all printable, ?? literal '?'
+// Any other character is a literal
+typedef struct
+{
+    char charsets[MAX_MASK_LENGTH][MAX_CHARSET_SIZE]; // Characters allowed at each position
+    size_t sizes[MAX_MASK_LENGTH];                    // Size of each charset
+    size_t length;                                    // Number of positions
+    uint64_t keyspace;                                // Number of candidates covered by the mask
+} Mask_t;
+
+// Parse a mask string, returns false on syntax error or keyspace overflow
+bool parse_mask(const char *mask_string, Mask_t *mask);
+
+// Set the odometer to candidate 'index' and write its characters to output
+void mask_seek(const Mask_t *mask, uint64_t index, size_t positions[], unsigned char *output);
+
+// Advance the odometer by one candidate, rewriting only the characters that change
+// Last position varies fastest, matching the index order of mask_seek
+static inline void mask_next(const Mask_t *mask, size_t positions[], unsigned char *output)
+{
+    size_t i = mask->length;
+
+    while (i > 0)
+    {
+        i--;
+        if (++positions[i] < mask->sizes[i])
+        {
+            output[i] = (unsigned char)mask->charsets[i][positions[i]];
+            return;
+        }
+        positions[i] = 0;
+        output[i] = (unsigned char)mask->charsets[i][0];
+    }
+}
+
+#endif // MASK_H
@@ -0,0 +1,59 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "hash_utils.h"
+
+// Stages of the cracking loop measured by --profile
+typedef enum
+{
+    PHASE_READ,
+    PHASE_HASH,
+    PHASE_MATCH,
+    PHASE_COUNT
+} Phase_t;
+
+// Hardware counters read for each phase
+typedef enum
+{
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_CACHE_MISSES,
+    COUNTER_BRANCH_MISSES,
+    COUNTER_COUNT
+} Counter_t;
+
+// Accumulated per-phase measurements
+typedef struct
+{
+    int group_fd;                                   // perf event group leader, -1 if unavailable
+    int fds[COUNTER_COUNT];                         // perf event of each counter, -1 if not opened
+    int counter_index[COUNTER_COUNT];               // Position of each counter in a group read, -1 if not opened
+    size_t counters_open;                           // Counters in the group
+    char unavailable[128];                          // Why hardware counters are not available, empty if they are
+    uint64_t run_start_ticks;                       // Timer value when the profile was opened
+    uint64_t run_start_ns;                          // Monotonic clock when the profile was opened
+    uint64_t start_ticks;                           // Timer value at phase begin
+    uint64_t start_counters[COUNTER_COUNT];         // Counter values at phase begin
+    uint64_t ticks[PHASE_COUNT];                    // Accumulated timer ticks per phase
+    uint64_t counters[PHASE_COUNT][COUNTER_COUNT];  // Accumulated counter deltas per phase
+    uint64_t candidates;                            // Candidates processed
+} Profile_t;
+
+// Open the hardware counters, falling back to timers only when they are unavailable
+void profile_open(Profile_t *profile);
+void profile_close(Profile_t *profile);
+
+// Measure the code between begin and end as part of a phase
+void profile_begin(Profile_t *profile);
+void profile_end(Profile_t *profile, Phase_t phase);
+
+// Print the per-phase breakdown since profile_open
+void profile_report(const Profile_t *profile, FILE *out);
+
+// Wordlist attack with per-phase profiling of the read, hash and match stages
+int crack_hash_profile(Hash_t *args, const char *hash, const char *wordlist);
+
+#endif // PROFILE_H
@@ -0,0 +1,63 @@
+#ifndef TARGETS_H
+#define TARGETS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define TARGET_MAX_LENGTHS 16       // Digest lengths loaded from one hash file
+
+// Set of target digests, packed back to back, sorted and deduplicated
+typedef struct
+{
+    unsigned char *digests;     // count * digest_length bytes
+    size_t digest_length;       // Digest length in bytes
+    size_t count;               // Number of unique targets
+    bool *cracked;              // Whether each target has been cracked
+    size_t remaining;           // Targets not cracked yet
+} TargetSet_t;
+
+// Statistics of a hash file load
+typedef struct
+{
+    size_t total;               // Hash lines (excluding empty lines and comments)
+    size_t invalid;             // Rejected lines
+    size_t duplicates;          // Valid lines removed as duplicates
+} LoadStats_t;
+
+// Load, decode, sort and deduplicate every hash of a hash file
+// Rejected lines are reported on stderr with their line number
+bool load_hash_file(const char *path, size_t digest_length, const char *alg_name,
+                    TargetSet_t *targets, LoadStats_t *stats);
+
+// Load a hash file mixing several digest lengths, into targets[i] for digest_lengths[i]
+// The file is read once; lines matching none of the lengths are rejected
+bool load_hash_file_lengths(const char *path, const size_t *digest_lengths, size_t length_count,
+                            const char *alg_name, TargetSet_t *targets, LoadStats_t *stats);
+
+void free_targets(TargetSet_t *targets);
+
+// Index of digest in the set, or SIZE_MAX if it is not a target
+static inline size_t target_lookup(const TargetSet_t *targets, const unsigned char *digest)
+{
+    size_t low = 0;
+    size_t high = targets->count;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        int cmp = memcmp(targets->digests + middle * targets->digest_length, digest, targets->digest_length);
+
+        if (cmp == 0)
+            return middle;
+        if (cmp < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return SIZE_MAX;
+}
+
+#endif // TARGETS_H
@@ -2,10 +2,41 @@
 #define UTILS_H
 
 #include <stdio.h>
+#include <stdbool.h>
 
 #define MAX_LENGTH 64 // Maximum buffer length for reading lines
+#define MAX_WORD_LENGTH 256 // Maximum buffer length for words of the attack modes
+#define MAX_THREADS 64 // Upper bound on worker threads
+
+// Wordlist held in memory, words stored back to back and NUL-terminated
+typedef struct
+{
+    char *data;                 // Word storage
+    size_t *offsets;            // Offset of each word in data
+    size_t *lengths;            // Length of each word
+    size_t count;               // Number of words
+} WordList_t;
 
 // Reads a line from a file into buffer
 char *read_line(FILE *file, char *buffer, int size);
 
+// Load a whole wordlist into memory / release it
+bool load_wordlist(const char *path, WordList_t *list);
+void free_wordlist(WordList_t *list);
+
+// Number of worker threads to use (online CPUs, capped to MAX_THREADS)
+size_t thread_count(void);
+
+// Stop flag shared by the worker threads of an attack
+// Read and written atomically; the found password itself is only read after the threads are joined
+static inline bool stop_requested(const int *stop)
+{
+    return __atomic_load_n(stop, __ATOMIC_RELAXED) != 0;
+}
+
+static inline void request_stop(int *stop)
+{
+    __atomic_store_n(stop, 1, __ATOMIC_RELAXED);
+}
+
 #endif
\ No newline at end of file
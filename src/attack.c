@@ -0,0 +1,561 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include "attack.h"
+#include "utils.h"
+
+#define HYBRID_BATCH 1024               // Base words read per batch in hybrid mode
+#define HYBRID_MAX_BATCH 16384          // Base words per batch for short masks
+#define HYBRID_BATCH_BYTES (HYBRID_BATCH * MAX_WORD_LENGTH) // Word storage per batch
+#define HYBRID_BATCH_CANDIDATES 65536   // Candidates per batch aimed for when the mask is short
+#define HYBRID_CLAIMS_PER_THREAD 8      // Ranges each worker claims per batch, for load balancing
+#define HYBRID_MIN_CLAIM 256            // Smallest range of candidates claimed at once
+#define HYBRID_STOP_CHECK 0xfff         // Check the stop flag every 4096 candidates
+
+// Specialized combinator loops, one per algorithm, generated from FAST_HASH_LIST
+// A left word of at least one block is absorbed once and its hash state copied
+// for every right word; shorter left words are joined with each right word and
+// hashed through the single-block kernel
+#define DEFINE_COMBINE_LOOP(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE)  \
+    int combine_loop_##NAME(const unsigned char *target, const char *left, size_t left_length,  \
+                            const WordList_t *right, char *found, size_t found_size)            \
+    {                                                                                           \
+        unsigned char digest[DIGEST_LENGTH];                                                    \
+                                                                                                \
+        if (left_length >= BLOCK_SIZE)                                                          \
+        {                                                                                       \
+            CTX prefix;                                                                         \
+            INIT(&prefix);                                                                      \
+            UPDATE(&prefix, left, left_length);                                                 \
+                                                                                                \
+            for (size_t i = 0; i < right->count; i++)                                           \
+            {                                                                                   \
+                CTX ctx = prefix;                                                               \
+                UPDATE(&ctx, right->data + right->offsets[i], right->lengths[i]);               \
+                FINAL(digest, &ctx);                                                            \
+                                                                                                \
+                if (memcmp(digest, target, DIGEST_LENGTH) == 0)                                 \
+                {                                                                               \
+                    snprintf(found, found_size, "%s%s", left, right->data + right->offsets[i]); \
+                    return EXIT_SUCCESS;                                                        \
+                }                                                                               \
+            }                                                                                   \
+                                                                                                \
+            return -1;                                                                          \
+        }                                                                                       \
+                                                                                                \
+        unsigned char candidate[MAX_WORD_LENGTH * 2];                                           \
+        memcpy(candidate, left, left_length);                                                   \
+                                                                                                \
+        for (size_t i = 0; i < right->count; i++)                                               \
+        {                                                                                       \
+            size_t right_length = right->lengths[i];                                            \
+            memcpy(candidate + left_length, right->data + right->offsets[i], right_length);     \
+            KERNEL(candidate, left_length + right_length, digest);                              \
+                                                                                                \
+            if (memcmp(digest, target, DIGEST_LENGTH) == 0)                                     \
+            {                                                                                   \
+                snprintf(found, found_size, "%s%s", left, right->data + right->offsets[i]);     \
+                return EXIT_SUCCESS;                                                            \
+            }                                                                                   \
+        }                                                                                       \
+                                                                                                \
+        return -1;                                                                              \
+    }
+
+FAST_HASH_LIST(DEFINE_COMBINE_LOOP)
+
+#undef DEFINE_COMBINE_LOOP
+
+// Specialized hybrid loops, one per algorithm, generated from FAST_HASH_LIST
+// The base word is copied once, then the mask part of the candidate is
+// incremented in place so each step rewrites only the characters that change
+#define DEFINE_HYBRID_LOOP(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE)   \
+    int hybrid_loop_##NAME(const HybridJob_t *job, char *found, size_t found_size)             \
+    {                                                                                           \
+        unsigned char candidate[MAX_WORD_LENGTH + MAX_MASK_LENGTH];                             \
+        unsigned char digest[DIGEST_LENGTH];                                                    \
+        size_t positions[MAX_MASK_LENGTH];                                                      \
+        size_t length = job->word_length + job->mask->length;                                   \
+        unsigned char *mask_part = job->mask_first ? candidate : candidate + job->word_length;  \
+                                                                                                \
+        memcpy(job->mask_first ? candidate + job->mask->length : candidate,                     \
+               job->word, job->word_length);                                                    \
+        mask_seek(job->mask, job->start, positions, mask_part);                                 \
+                                                                                                \
+        for (uint64_t i = job->start; i < job->end; i++)                                        \
+        {                                                                                       \
+            if (((i - job->start) & HYBRID_STOP_CHECK) == 0 && stop_requested(job->stop))       \
+            {                                                                                   \
+                return -1;                                                                      \
+            }                                                                                   \
+                                                                                                \
+            KERNEL(candidate, length, digest);                                                  \
+                                                                                                \
+            if (memcmp(digest, job->target, DIGEST_LENGTH) == 0)                             \
+            {                                                                                   \
+                snprintf(found, found_size, "%.*s", (int)length, (const char *)candidate);     \
+                return EXIT_SUCCESS;                                                            \
+            }                                                                                   \
+                                                                                                \
+            mask_next(job->mask, positions, mask_part);                                         \
+        }                                                                                       \
+                                                                                                \
+        return -1;                                                                              \
+    }
+
+FAST_HASH_LIST(DEFINE_HYBRID_LOOP)
+
+#undef DEFINE_HYBRID_LOOP
+
+// Generic combinator loop through the hash function pointer
+static int combine_generic(const Hash_t *args, const unsigned char *target, const char *left, size_t left_length,
+                           const WordList_t *right, char *found, size_t found_size)
+{
+    unsigned char candidate[MAX_WORD_LENGTH * 2];
+    unsigned char digest[args->digest_length];
+    memcpy(candidate, left, left_length);
+
+    for (size_t i = 0; i < right->count; i++)
+    {
+        size_t right_length = right->lengths[i];
+        memcpy(candidate + left_length, right->data + right->offsets[i], right_length);
+        args->alg(candidate, left_length + right_length, digest);
+
+        if (memcmp(digest, target, args->digest_length) == 0)
+        {
+            snprintf(found, found_size, "%s%s", left, right->data + right->offsets[i]);
+            return EXIT_SUCCESS;
+        }
+    }
+
+    return -1;
+}
+
+// Attempt to crack the hash with every left+right word combination
+// The right wordlist is kept in memory, the left one is streamed
+int crack_combinator(Hash_t *args, const char *hash, const char *left_path, const char *right_path)
+{
+    if (args == NULL)
+    {
+        fprintf(stderr, "\nHash structure is NULL, can't crack hash.\n");
+        return EXIT_FAILURE;
+    }
+
+    unsigned char target[args->digest_length];
+    if (!hex_to_digest(hash, target, args->digest_length))
+    {
+        fprintf(stderr, "\nInvalid target hash '%s' for algorithm '%s'.\n", hash, args->name);
+        return EXIT_FAILURE;
+    }
+
+    WordList_t right;
+    if (!load_wordlist(right_path, &right))
+    {
+        return EXIT_FAILURE;
+    }
+
+    FILE *left_file = fopen(left_path, "r");
+    if (left_file == NULL)
+    {
+        fprintf(stderr, "Error opening file '%s': %s\n", left_path, strerror(errno));
+        free_wordlist(&right);
+        return EXIT_FAILURE;
+    }
+
+    char buffer[MAX_WORD_LENGTH];
+    char found[MAX_WORD_LENGTH * 2];
+    char *left;
+    int result = -1;
+
+    // One dispatch per left word, the whole right wordlist is covered inside
+    while (result != EXIT_SUCCESS && (left = read_line(left_file, buffer, MAX_WORD_LENGTH)))
+    {
+        size_t left_length = strlen(left);
+
+        if (args->combine != NULL)
+        {
+            result = args->combine(target, left, left_length, &right, found, sizeof(found));
+        }
+        else
+        {
+            result = combine_generic(args, target, left, left_length, &right, found, sizeof(found));
+        }
+    }
+
+    fclose(left_file);
+    free_wordlist(&right);
+
+    if (result == EXIT_SUCCESS)
+    {
+        printf("\nFound pass : %s\n", found);
+        return EXIT_SUCCESS;
+    }
+
+    printf("\nNo pass was found.\n");
+    return -1;
+}
+
+// Generic hybrid loop through the hash function pointer
+static int hybrid_generic(const Hash_t *args, const HybridJob_t *job, char *found, size_t found_size)
+{
+    unsigned char candidate[MAX_WORD_LENGTH + MAX_MASK_LENGTH];
+    unsigned char digest[args->digest_length];
+    size_t positions[MAX_MASK_LENGTH];
+    size_t length = job->word_length + job->mask->length;
+    unsigned char *mask_part = job->mask_first ? candidate : candidate + job->word_length;
+
+    memcpy(job->mask_first ? candidate + job->mask->length : candidate, job->word, job->word_length);
+    mask_seek(job->mask, job->start, positions, mask_part);
+
+    for (uint64_t i = job->start; i < job->end; i++)
+    {
+        if (((i - job->start) & HYBRID_STOP_CHECK) == 0 && stop_requested(job->stop))
+        {
+            return -1;
+        }
+
+        args->alg(candidate, length, digest);
+
+        if (memcmp(digest, job->target, args->digest_length) == 0)
+        {
+            snprintf(found, found_size, "%.*s", (int)length, (const char *)candidate);
+            return EXIT_SUCCESS;
+        }
+
+        mask_next(job->mask, positions, mask_part);
+    }
+
+    return -1;
+}
+
+// One batch of base words, stored back to back and NUL-terminated
+typedef struct
+{
+    char *data;
+    size_t *offsets;
+    size_t *lengths;
+    size_t count;
+} HybridBatch_t;
+
+// State shared by the hybrid worker pool
+// The pool threads are started once per run. For each batch the calling thread publishes
+// the batch, reads the next one while the pool hashes, then helps until the batch is drained
+typedef struct
+{
+    const Hash_t *args;
+    const unsigned char *target;
+    const Mask_t *mask;
+    bool mask_first;
+    pthread_mutex_t lock;
+    pthread_cond_t batch_ready;     // A batch was published or the run is over
+    pthread_cond_t batch_done;      // Every pool thread is done with the current batch
+    unsigned long generation;       // Batches published so far
+    size_t busy;                    // Pool threads still working on the current batch
+    bool finished;
+    const HybridBatch_t *batch;     // Current batch
+    uint64_t total;                 // Candidates of the current batch (words x mask keyspace)
+    uint64_t claim;                 // Candidates claimed at once by a worker
+    uint64_t next;                  // First unclaimed candidate, updated atomically
+    int stop;                       // See stop_requested
+    int result;
+    char found[MAX_WORD_LENGTH + MAX_MASK_LENGTH];
+} HybridPool_t;
+
+// Claim the next range of the current batch, returns false once it is exhausted
+static bool claim_range(HybridPool_t *pool, uint64_t *start, uint64_t *end)
+{
+    uint64_t index = __atomic_load_n(&pool->next, __ATOMIC_RELAXED);
+    uint64_t count;
+
+    do
+    {
+        if (index >= pool->total)
+            return false;
+
+        count = pool->total - index;
+        if (count > pool->claim)
+            count = pool->claim;
+    } while (!__atomic_compare_exchange_n(&pool->next, &index, index + count, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    *start = index;
+    *end = index + count;
+    return true;
+}
+
+// Hash claimed ranges of the current batch until it is exhausted or the password is found
+// Each range is split into per-word mask ranges
+static void hybrid_drain(HybridPool_t *pool)
+{
+    const HybridBatch_t *batch = pool->batch;
+    uint64_t keyspace = pool->mask->keyspace;
+    char found[MAX_WORD_LENGTH + MAX_MASK_LENGTH];
+    uint64_t index;
+    uint64_t end;
+
+    while (!stop_requested(&pool->stop) && claim_range(pool, &index, &end))
+    {
+        while (index < end)
+        {
+            size_t word = (size_t)(index / keyspace);
+            uint64_t mask_index = index % keyspace;
+            uint64_t count = keyspace - mask_index;
+            if (count > end - index)
+                count = end - index;
+
+            HybridJob_t job;
+            job.target = pool->target;
+            job.mask = pool->mask;
+            job.word = batch->data + batch->offsets[word];
+            job.word_length = batch->lengths[word];
+            job.mask_first = pool->mask_first;
+            job.start = mask_index;
+            job.end = mask_index + count;
+            job.stop = &pool->stop;
+
+            int result;
+            if (pool->args->hybrid != NULL)
+            {
+                result = pool->args->hybrid(&job, found, sizeof(found));
+            }
+            else
+            {
+                result = hybrid_generic(pool->args, &job, found, sizeof(found));
+            }
+
+            if (result == EXIT_SUCCESS)
+            {
+                pthread_mutex_lock(&pool->lock);
+                if (pool->result != EXIT_SUCCESS)
+                {
+                    memcpy(pool->found, found, sizeof(found));
+                    pool->result = EXIT_SUCCESS;
+                }
+                pthread_mutex_unlock(&pool->lock);
+                request_stop(&pool->stop);
+                return;
+            }
+
+            index += count;
+        }
+    }
+}
+
+// Pool thread entry point: drain every published batch until the run is over
+static void *hybrid_thread(void *arg)
+{
+    HybridPool_t *pool = arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (pool->generation == seen && !pool->finished)
+        {
+            pthread_cond_wait(&pool->batch_ready, &pool->lock);
+        }
+        if (pool->finished)
+        {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        hybrid_drain(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0)
+        {
+            pthread_cond_signal(&pool->batch_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+// Read up to 'capacity' base words while they fit in the batch storage,
+// nothing once the password was found
+static void read_batch(FILE *file, HybridBatch_t *batch, size_t capacity, const int *stop)
+{
+    size_t used = 0;
+
+    batch->count = 0;
+    while (batch->count < capacity && used + MAX_WORD_LENGTH <= HYBRID_BATCH_BYTES &&
+           !stop_requested(stop) && read_line(file, batch->data + used, MAX_WORD_LENGTH))
+    {
+        size_t length = strlen(batch->data + used);
+        batch->offsets[batch->count] = used;
+        batch->lengths[batch->count] = length;
+        batch->count++;
+        used += length + 1;
+    }
+}
+
+// Attempt to crack the hash with every wordlist word expanded by the mask
+// Words are read in batches; each batch's (word x mask) space is shared by a worker pool
+// while the next batch is read
+int crack_hybrid(Hash_t *args, const char *hash, const char *wordlist, const char *mask_string, bool mask_first)
+{
+    if (args == NULL)
+    {
+        fprintf(stderr, "\nHash structure is NULL, can't crack hash.\n");
+        return EXIT_FAILURE;
+    }
+
+    unsigned char target[args->digest_length];
+    if (!hex_to_digest(hash, target, args->digest_length))
+    {
+        fprintf(stderr, "\nInvalid target hash '%s' for algorithm '%s'.\n", hash, args->name);
+        return EXIT_FAILURE;
+    }
+
+    Mask_t mask;
+    if (!parse_mask(mask_string, &mask))
+    {
+        fprintf(stderr, "\nInvalid mask '%s'.\n", mask_string);
+        return EXIT_FAILURE;
+    }
+
+    FILE *file = fopen(wordlist, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error opening file '%s': %s\n", wordlist, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    // Short masks get more words per batch so every batch has enough candidates to share,
+    // while the flattened batch space stays within 64 bits
+    size_t batch_words = HYBRID_BATCH;
+    if (mask.keyspace < HYBRID_BATCH_CANDIDATES / HYBRID_BATCH)
+    {
+        batch_words = HYBRID_BATCH_CANDIDATES / (size_t)mask.keyspace;
+        if (batch_words > HYBRID_MAX_BATCH)
+            batch_words = HYBRID_MAX_BATCH;
+    }
+    if (mask.keyspace > UINT64_MAX / batch_words)
+    {
+        batch_words = 1;
+    }
+
+    // Two batches: one being hashed, the next one being read
+    HybridBatch_t batches[2];
+    bool ok = true;
+    for (size_t i = 0; i < 2; i++)
+    {
+        batches[i].data = malloc(HYBRID_BATCH_BYTES);
+        batches[i].offsets = malloc(batch_words * sizeof(size_t));
+        batches[i].lengths = malloc(batch_words * sizeof(size_t));
+        batches[i].count = 0;
+        ok = ok && batches[i].data != NULL && batches[i].offsets != NULL && batches[i].lengths != NULL;
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "\nMemory allocation failed in crack_hybrid.\n");
+        for (size_t i = 0; i < 2; i++)
+        {
+            free(batches[i].data);
+            free(batches[i].offsets);
+            free(batches[i].lengths);
+        }
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    HybridPool_t pool;
+    pool.args = args;
+    pool.target = target;
+    pool.mask = &mask;
+    pool.mask_first = mask_first;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.batch_ready, NULL);
+    pthread_cond_init(&pool.batch_done, NULL);
+    pool.generation = 0;
+    pool.busy = 0;
+    pool.finished = false;
+    pool.batch = NULL;
+    pool.total = 0;
+    pool.claim = 1;
+    pool.next = 0;
+    pool.stop = 0;
+    pool.result = -1;
+
+    // The calling thread is a worker too, the pool holds the others
+    size_t threads = thread_count();
+    pthread_t thread_ids[MAX_THREADS];
+    size_t started = 0;
+    for (; started + 1 < threads; started++)
+    {
+        if (pthread_create(&thread_ids[started], NULL, hybrid_thread, &pool) != 0)
+        {
+            break;
+        }
+    }
+
+    size_t current = 0;
+    read_batch(file, &batches[current], batch_words, &pool.stop);
+
+    while (batches[current].count > 0 && !stop_requested(&pool.stop))
+    {
+        uint64_t total = (uint64_t)batches[current].count * mask.keyspace;
+        uint64_t claim = total / ((started + 1) * HYBRID_CLAIMS_PER_THREAD);
+
+        // Hand the batch to the pool
+        pthread_mutex_lock(&pool.lock);
+        pool.batch = &batches[current];
+        pool.total = total;
+        pool.claim = (claim < HYBRID_MIN_CLAIM) ? HYBRID_MIN_CLAIM : claim;
+        __atomic_store_n(&pool.next, 0, __ATOMIC_RELAXED);
+        pool.busy = started;
+        pool.generation++;
+        pthread_cond_broadcast(&pool.batch_ready);
+        pthread_mutex_unlock(&pool.lock);
+
+        // Read the next batch while the pool hashes this one, then help drain it
+        read_batch(file, &batches[current ^ 1], batch_words, &pool.stop);
+        hybrid_drain(&pool);
+
+        pthread_mutex_lock(&pool.lock);
+        while (pool.busy > 0)
+        {
+            pthread_cond_wait(&pool.batch_done, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+
+        current ^= 1;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.finished = true;
+    pthread_cond_broadcast(&pool.batch_ready);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (size_t t = 0; t < started; t++)
+    {
+        pthread_join(thread_ids[t], NULL);
+    }
+
+    pthread_cond_destroy(&pool.batch_done);
+    pthread_cond_destroy(&pool.batch_ready);
+    pthread_mutex_destroy(&pool.lock);
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        free(batches[i].data);
+        free(batches[i].offsets);
+        free(batches[i].lengths);
+    }
+    fclose(file);
+
+    if (pool.result == EXIT_SUCCESS)
+    {
+        printf("\nFound pass : %s\n", pool.found);
+        return EXIT_SUCCESS;
+    }
+
+    printf("\nNo pass was found.\n");
+    return -1;
+}
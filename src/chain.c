@@ -0,0 +1,418 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include "chain.h"
+#include "hash_utils.h"
+#include "fast_hash.h"
+#include "utils.h"
+
+#define CHAIN_ERROR (SIZE_MAX - 1) // Parse failure, distinct from CHAIN_INPUT and step indexes
+
+// Kernel indexes, generated from FAST_HASH_LIST
+#define CHAIN_FUNCTION_ID(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE) \
+    CHAIN_FUNCTION_##NAME,
+
+enum
+{
+    FAST_HASH_LIST(CHAIN_FUNCTION_ID)
+    CHAIN_FUNCTION_COUNT
+};
+
+#undef CHAIN_FUNCTION_ID
+
+// Function names usable in expressions, matched case-insensitively
+#define CHAIN_FUNCTION_ENTRY(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE) \
+    { #NAME, DIGEST_LENGTH },
+
+static const struct
+{
+    const char *name;
+    size_t digest_length;
+} chain_functions[CHAIN_FUNCTION_COUNT] = {
+    FAST_HASH_LIST(CHAIN_FUNCTION_ENTRY)
+};
+
+#undef CHAIN_FUNCTION_ENTRY
+
+// Run a kernel by index; the switch calls each kernel directly so it can be inlined
+static void run_kernel(size_t function, const unsigned char *input, size_t length, unsigned char *digest)
+{
+#define CHAIN_FUNCTION_CASE(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE) \
+    case CHAIN_FUNCTION_##NAME:                                                                \
+        KERNEL(input, length, digest);                                                         \
+        break;
+
+    switch (function)
+    {
+        FAST_HASH_LIST(CHAIN_FUNCTION_CASE)
+    default:
+        break;
+    }
+
+#undef CHAIN_FUNCTION_CASE
+}
+
+// Lowercase hexadecimal encoding, without a terminator
+static void encode_hex(const unsigned char *input, size_t length, unsigned char *output)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < length; i++)
+    {
+        output[i * 2] = (unsigned char)digits[input[i] >> 4];
+        output[i * 2 + 1] = (unsigned char)digits[input[i] & 0x0f];
+    }
+}
+
+// State of the expression being compiled
+typedef struct
+{
+    const char *text;
+    size_t length;
+    size_t position;
+    size_t depth;
+    ChainPlan_t *plan;
+    char error[96];
+} Parser_t;
+
+static char peek(const Parser_t *parser)
+{
+    return (parser->position < parser->length) ? parser->text[parser->position] : '\0';
+}
+
+static void skip_spaces(Parser_t *parser)
+{
+    while (isspace((unsigned char)peek(parser)))
+    {
+        parser->position++;
+    }
+}
+
+static size_t find_function(const char *name, size_t length)
+{
+    for (size_t i = 0; i < CHAIN_FUNCTION_COUNT; i++)
+    {
+        if (strncasecmp(name, chain_functions[i].name, length) == 0 && chain_functions[i].name[length] == '\0')
+        {
+            return i;
+        }
+    }
+
+    return SIZE_MAX;
+}
+
+// Index of the step computing 'op' on 'source', added if no identical step exists yet
+static size_t add_step(Parser_t *parser, ChainOp_t op, size_t function, size_t source)
+{
+    ChainPlan_t *plan = parser->plan;
+
+    for (size_t i = 0; i < plan->step_count; i++)
+    {
+        const ChainStep_t *step = &plan->steps[i];
+        if (step->op == op && step->function == function && step->source == source)
+        {
+            return i;
+        }
+    }
+
+    if (plan->step_count == CHAIN_MAX_STEPS)
+    {
+        snprintf(parser->error, sizeof(parser->error), "more than %d distinct steps", CHAIN_MAX_STEPS);
+        return CHAIN_ERROR;
+    }
+
+    size_t source_length = (source == CHAIN_INPUT) ? 0 : plan->steps[source].length;
+    ChainStep_t *step = &plan->steps[plan->step_count];
+    step->op = op;
+    step->function = function;
+    step->source = source;
+    step->length = (op == CHAIN_HASH) ? chain_functions[function].digest_length : source_length * 2;
+
+    return plan->step_count++;
+}
+
+// term := 'p' | FUNCTION [ '_hex' ] '(' term ')'
+static size_t parse_term(Parser_t *parser)
+{
+    skip_spaces(parser);
+
+    const char *name = parser->text + parser->position;
+    size_t length = 0;
+    while (isalnum((unsigned char)peek(parser)) || peek(parser) == '_')
+    {
+        parser->position++;
+        length++;
+    }
+
+    if (length == 0)
+    {
+        snprintf(parser->error, sizeof(parser->error), "expected a function or 'p' at position %zu", parser->position + 1);
+        return CHAIN_ERROR;
+    }
+
+    skip_spaces(parser);
+
+    if (length == 1 && (name[0] == 'p' || name[0] == 'P') && peek(parser) != '(')
+    {
+        return CHAIN_INPUT;
+    }
+
+    bool hex = false;
+    if (length > 4 && strncasecmp(name + length - 4, "_hex", 4) == 0)
+    {
+        hex = true;
+        length -= 4;
+    }
+
+    if (peek(parser) != '(')
+    {
+        snprintf(parser->error, sizeof(parser->error), "expected '(' after '%.*s'", (int)(length + (hex ? 4 : 0)), name);
+        return CHAIN_ERROR;
+    }
+    parser->position++;
+
+    size_t function = find_function(name, length);
+    if (function == SIZE_MAX)
+    {
+        snprintf(parser->error, sizeof(parser->error), "unknown function '%.*s'", (int)length, name);
+        return CHAIN_ERROR;
+    }
+
+    if (++parser->depth > CHAIN_MAX_STEPS)
+    {
+        snprintf(parser->error, sizeof(parser->error), "nested more than %d levels deep", CHAIN_MAX_STEPS);
+        return CHAIN_ERROR;
+    }
+
+    size_t source = parse_term(parser);
+    parser->depth--;
+    if (source == CHAIN_ERROR)
+    {
+        return CHAIN_ERROR;
+    }
+
+    skip_spaces(parser);
+    if (peek(parser) != ')')
+    {
+        snprintf(parser->error, sizeof(parser->error), "expected ')' at position %zu", parser->position + 1);
+        return CHAIN_ERROR;
+    }
+    parser->position++;
+
+    size_t step = add_step(parser, CHAIN_HASH, function, source);
+    if (hex && step != CHAIN_ERROR)
+    {
+        step = add_step(parser, CHAIN_HEX, 0, step);
+    }
+
+    return step;
+}
+
+// Compile one expression of 'length' characters and add it to the plan
+static bool compile_expression(const char *text, size_t length, ChainPlan_t *plan)
+{
+    // Trim surrounding whitespace for reports
+    while (length > 0 && isspace((unsigned char)*text))
+    {
+        text++;
+        length--;
+    }
+    while (length > 0 && isspace((unsigned char)text[length - 1]))
+    {
+        length--;
+    }
+
+    Parser_t parser = { text, length, 0, 0, plan, "" };
+    size_t step = parse_term(&parser);
+
+    if (step != CHAIN_ERROR)
+    {
+        skip_spaces(&parser);
+
+        if (parser.position != length)
+        {
+            snprintf(parser.error, sizeof(parser.error), "unexpected '%c' at position %zu", peek(&parser), parser.position + 1);
+            step = CHAIN_ERROR;
+        }
+        else if (step == CHAIN_INPUT)
+        {
+            snprintf(parser.error, sizeof(parser.error), "no function is applied to the password");
+            step = CHAIN_ERROR;
+        }
+        else if (plan->steps[step].op == CHAIN_HEX)
+        {
+            snprintf(parser.error, sizeof(parser.error), "the outer digest is compared raw, drop its '_hex' suffix");
+            step = CHAIN_ERROR;
+        }
+    }
+
+    if (step == CHAIN_ERROR)
+    {
+        fprintf(stderr, "\nError: Invalid expression '%.*s': %s.\n", (int)length, text, parser.error);
+        return false;
+    }
+
+    // The same expression given twice is only checked once
+    for (size_t i = 0; i < plan->expression_count; i++)
+    {
+        if (plan->expressions[i].step == step)
+        {
+            return true;
+        }
+    }
+
+    if (plan->expression_count == CHAIN_MAX_EXPRESSIONS)
+    {
+        fprintf(stderr, "\nError: Too many expressions (at most %d).\n", CHAIN_MAX_EXPRESSIONS);
+        return false;
+    }
+
+    ChainExpression_t *expression = &plan->expressions[plan->expression_count++];
+    snprintf(expression->text, sizeof(expression->text), "%.*s", (int)length, text);
+    expression->step = step;
+    expression->digest_length = plan->steps[step].length;
+
+    return true;
+}
+
+// True if an algorithm argument is an expression rather than an algorithm name
+bool is_chain_expression(const char *text)
+{
+    return text != NULL && strchr(text, '(') != NULL;
+}
+
+// Compile comma-separated expressions into the plan
+bool chain_compile(const char *text, ChainPlan_t *plan)
+{
+    if (text == NULL || plan == NULL)
+    {
+        return false;
+    }
+
+    plan->step_count = 0;
+    plan->expression_count = 0;
+
+    for (;;)
+    {
+        const char *comma = strchr(text, ',');
+        size_t length = comma ? (size_t)(comma - text) : strlen(text);
+
+        if (!compile_expression(text, length, plan))
+        {
+            return false;
+        }
+
+        if (comma == NULL)
+        {
+            break;
+        }
+        text = comma + 1;
+    }
+
+    return true;
+}
+
+// Crack target sets with the expressions of matching digest length, in a single wordlist pass
+// Each step is evaluated once per candidate, however many expressions share it
+size_t chain_crack(const ChainPlan_t *plan, TargetSet_t *targets, size_t set_count, const char *wordlist)
+{
+    if (plan == NULL || targets == NULL)
+    {
+        fprintf(stderr, "\nChain plan is NULL, can't crack hash.\n");
+        return 0;
+    }
+
+    // Only the steps leading to an expression with hashes of its length left are evaluated
+    bool needed[CHAIN_MAX_STEPS] = { false };
+    size_t active[CHAIN_MAX_EXPRESSIONS];
+    TargetSet_t *active_sets[CHAIN_MAX_EXPRESSIONS];
+    size_t active_count = 0;
+    size_t remaining = 0;
+
+    for (size_t j = 0; j < set_count; j++)
+    {
+        remaining += targets[j].remaining;
+    }
+
+    for (size_t i = 0; i < plan->expression_count; i++)
+    {
+        TargetSet_t *set = NULL;
+        for (size_t j = 0; j < set_count && set == NULL; j++)
+        {
+            if (targets[j].digest_length == plan->expressions[i].digest_length && targets[j].remaining > 0)
+                set = &targets[j];
+        }
+
+        if (set == NULL)
+            continue;
+
+        active[active_count] = i;
+        active_sets[active_count++] = set;
+        for (size_t step = plan->expressions[i].step; step != CHAIN_INPUT && !needed[step]; step = plan->steps[step].source)
+        {
+            needed[step] = true;
+        }
+    }
+
+    if (active_count == 0)
+    {
+        return 0;
+    }
+
+    FILE *file = fopen(wordlist, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error opening file '%s': %s\n", wordlist, strerror(errno));
+        return 0;
+    }
+
+    char buffer[MAX_LENGTH];
+    unsigned char outputs[CHAIN_MAX_STEPS][CHAIN_MAX_OUTPUT];
+    char hex[CHAIN_MAX_OUTPUT + 1];
+    size_t cracked = 0;
+    char *line;
+
+    while (remaining > 0 && (line = read_line(file, buffer, MAX_LENGTH)))
+    {
+        size_t line_length = strlen(line);
+
+        for (size_t i = 0; i < plan->step_count; i++)
+        {
+            if (!needed[i])
+                continue;
+
+            const ChainStep_t *step = &plan->steps[i];
+            const unsigned char *input = (step->source == CHAIN_INPUT) ? (const unsigned char *)line : outputs[step->source];
+            size_t input_length = (step->source == CHAIN_INPUT) ? line_length : plan->steps[step->source].length;
+
+            if (step->op == CHAIN_HASH)
+                run_kernel(step->function, input, input_length, outputs[i]);
+            else
+                encode_hex(input, input_length, outputs[i]);
+        }
+
+        for (size_t i = 0; i < active_count; i++)
+        {
+            const ChainExpression_t *expression = &plan->expressions[active[i]];
+            TargetSet_t *set = active_sets[i];
+            size_t index = target_lookup(set, outputs[expression->step]);
+
+            if (index != SIZE_MAX && !set->cracked[index])
+            {
+                set->cracked[index] = true;
+                set->remaining--;
+                remaining--;
+                cracked++;
+
+                hash_to_hex(set->digests + index * set->digest_length, set->digest_length, hex);
+                printf("Found pass : %s (%s) with %s\n", line, hex, expression->text);
+            }
+        }
+    }
+
+    fclose(file);
+    return cracked;
+}
@@ -2,11 +2,15 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <strings.h>
 #include <limits.h>
 #include <ctype.h>
 #include <sys/stat.h>
 #include "cli.h"
 #include "hash_utils.h"
+#include "attack.h"
+#include "markov.h"
+#include "chain.h"
 
 // Print usage information for the program
 void print_usage(const char *program_name)
@@ -18,6 +22,8 @@ void print_usage(const char *program_name)
 
     printf("\nUsage : %s <ALG_NAME> <HASH> <WORDLIST_PATH>\n", program_name);
     printf("   or : %s <ALG_NAME> -f <HASH_FILE> <WORDLIST_PATH>\n", program_name);
+    printf("   or : %s <ALG_NAME> <HASH> -a <MODE> <OPERANDS...>\n", program_name);
+    printf("   or : %s <EXPRESSIONS> <HASH | -f HASH_FILE> <WORDLIST_PATH>\n", program_name);
     printf("Try '%s -h' for more information.\n", program_name);
 }
 
@@ -28,7 +34,9 @@ void show_help(const char *program_name)
 
     printf("Usage:\n");
     printf("  %s <ALG_NAME> <HASH> <WORDLIST_PATH>\n", program_name);
-    printf("  %s <ALG_NAME> -f <HASH_FILE> <WORDLIST_PATH>\n\n", program_name);
+    printf("  %s <ALG_NAME> -f <HASH_FILE> <WORDLIST_PATH>\n", program_name);
+    printf("  %s <ALG_NAME> <HASH> -a <MODE> <OPERANDS...>\n", program_name);
+    printf("  %s <EXPRESSIONS> <HASH | -f HASH_FILE> <WORDLIST_PATH>\n\n", program_name);
     printf("Arguments:\n");
     printf("  ALG_NAME      Hash algorithm to use (e.g., md5, sha1, sha256)\n");
     printf("  HASH          Target hash to crack (hexadecimal format)\n");
@@ -37,12 +45,35 @@ void show_help(const char *program_name)
     printf("Options:\n");
     printf("  -h, --help    Show this help message\n");
     printf("  -l, --list    List all supported algorithms\n");
-    printf("  -f, --file    Read hashes from a file\n\n");
+    printf("  -f, --file    Read hashes from a file\n");
+    printf("  -a, --attack  Use another attack mode (see below)\n");
+    printf("  --profile     Report per-stage time and hardware counters (standard mode)\n\n");
+    printf("Attack modes:\n");
+    printf("  combinator LEFT_WORDLIST RIGHT_WORDLIST\n");
+    printf("                Try every left word followed by every right word\n");
+    printf("  hybrid-wm WORDLIST MASK\n");
+    printf("                Try every word followed by every mask candidate\n");
+    printf("  hybrid-mw MASK WORDLIST\n");
+    printf("                Try every mask candidate followed by every word\n");
+    printf("                Mask placeholders: ?l ?u ?d ?s ?a, ?? for '?', others are literals\n");
+    printf("  markov TRAINING_WORDLIST LENGTH\n");
+    printf("                Try candidates of LENGTH ('8' or '6-8') from most to least likely,\n");
+    printf("                using character statistics learned from the training wordlist\n\n");
+    printf("Expressions:\n");
+    printf("  Chained hashes replace ALG_NAME, e.g. 'sha1(md5_hex(p))' or 'md5(md5(p)),md5(md5_hex(p))'\n");
+    printf("                'p' is the password, functions are the algorithm names below ('-' as '_'),\n");
+    printf("                a '_hex' suffix passes the digest on as lowercase hex instead of raw bytes\n");
+    printf("                Comma-separated expressions are cracked in one pass, sharing common steps\n\n");
     printf("Examples:\n");
     printf("  %s md5 '5f4dcc3b5aa765d61d8327deb882cf99' rockyou.txt\n", program_name);
     printf("  %s sha1 '5baa61e4c9b93f3f0682250b6cf8331b7ee68fd8' rockyou.txt\n", program_name);
     printf("  %s sha256 '5e884898da28047151d0e56f8dc6292773603d0d6aabbdd62a11ef721d1542d8' rockyou.txt\n", program_name);
     printf("  %s md5 -f hashes.txt rockyou.txt\n", program_name);
+    printf("  %s md5 '5f4dcc3b5aa765d61d8327deb882cf99' rockyou.txt --profile\n", program_name);
+    printf("  %s md5 '5f4dcc3b5aa765d61d8327deb882cf99' -a combinator words.txt suffixes.txt\n", program_name);
+    printf("  %s md5 '5f4dcc3b5aa765d61d8327deb882cf99' -a hybrid-wm rockyou.txt '?d?d?d?d!'\n", program_name);
+    printf("  %s md5 '5f4dcc3b5aa765d61d8327deb882cf99' -a markov rockyou.txt 6-8\n", program_name);
+    printf("  %s 'md5(md5_hex(p)),md5(sha1_hex(p))' -f hashes.txt rockyou.txt\n", program_name);
 
     list_algorithms();
 }
@@ -144,105 +175,388 @@ bool validate_hash_file(const char *hash_file_path)
     return true;
 }
 
-// Process hash file and crack each hash
+// Print the summary of a hash file run
+static void print_file_summary(const LoadStats_t *stats, size_t cracked_hashes)
+{
+    printf("=== Summary ===\n");
+    printf("Total hashes processed: %zu\n", stats->total);
+    printf("Duplicate hashes: %zu\n", stats->duplicates);
+    printf("Successfully cracked: %zu\n", cracked_hashes);
+    printf("Failed to crack: %zu\n", stats->total - stats->invalid - stats->duplicates - cracked_hashes);
+    printf("Invalid hashes: %zu\n", stats->invalid);
+    printf("================\n");
+}
+
+// Process hash file and crack all of its hashes in a single wordlist pass
 int process_hash_file(const char *hash_file_path, const char *wordlist_path, Hash_t *args)
 {
-    FILE *hash_file = fopen(hash_file_path, "r");
-    if (hash_file == NULL)
+    printf("=== Processing hash file: %s ===\n", hash_file_path);
+    printf("Algorithm: %s\n", args->name);
+    printf("Wordlist: %s\n", wordlist_path);
+    printf("=====================================\n\n");
+
+    // Load, validate and deduplicate every hash up front
+    TargetSet_t targets;
+    LoadStats_t stats;
+    if (!load_hash_file(hash_file_path, args->digest_length, args->name, &targets, &stats))
     {
-        fprintf(stderr, "Error: Cannot open hash file '%s'\n", hash_file_path);
         return EXIT_FAILURE;
     }
 
-    char line[1024];
-    int line_number = 0;
-    int total_hashes = 0;
-    int cracked_hashes = 0;
-    int failed_hashes = 0;
+    printf("Loaded %zu unique hashes (%zu duplicates removed)\n", targets.count, stats.duplicates);
 
-    printf("=== Processing hash file: %s ===\n", hash_file_path);
-    printf("Algorithm: %s\n", args->name);
-    printf("Wordlist: %s\n", wordlist_path);
-    printf("=====================================\n\n");
+    size_t cracked_hashes = 0;
+    if (targets.count > 0)
+    {
+        cracked_hashes = crack_targets(args, &targets, wordlist_path);
+    }
+
+    printf("\n");
+    free_targets(&targets);
+
+    print_file_summary(&stats, cracked_hashes);
+    return (cracked_hashes > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-    while (fgets(line, sizeof(line), hash_file))
+// Validate attack mode arguments and run the requested attack
+int process_attack(int argc, char *argv[], int attack_index, const char *program_name)
+{
+    // Attack mode: ./hashcrack <ALG_NAME> <HASH> -a <MODE> <OPERANDS...>
+    if (attack_index != 3 || argc < 5)
+    {
+        fprintf(stderr, "\nError: Attack mode expects '<ALG_NAME> <HASH> -a <MODE> <OPERANDS...>'.\n");
+        print_usage(program_name);
+        return -1;
+    }
+
+    const char *alg_name = argv[1];
+    const char *hash = argv[2];
+    const char *mode = argv[attack_index + 1];
+    char **operands = &argv[attack_index + 2];
+    int operand_count = argc - attack_index - 2;
+
+    // Initialize hash algorithm structure for validation
+    Hash_t args;
+    args.name = NULL;
+    args.description = NULL;
+    args.id = 0;
+    args.digest_length = 0;
+    args.alg = NULL;
+    args.crack = NULL;
+    args.crack_multi = NULL;
+    args.combine = NULL;
+    args.hybrid = NULL;
+    args.hash_batch = NULL;
+
+    // Validate algorithm
+    if (!validate_algorithm(alg_name, &args))
+    {
+        fprintf(stderr, "\nError: Invalid or unsupported algorithm '%s'.\n", alg_name);
+        fprintf(stderr, "Use '%s -l' to see all supported algorithms.\n", program_name);
+        return -1;
+    }
+
+    // Validate hash format
+    if (!validate_hash_format(hash))
     {
-        line_number++;
+        fprintf(stderr, "\nError: Invalid hash format '%s'.\n", hash);
+        fprintf(stderr, "Hash must be in hexadecimal format (e.g., '5f4dcc3b5aa765d61d8327deb882cf99').\n");
+        return -1;
+    }
 
-        // Remove newline and carriage return
-        line[strcspn(line, "\r\n")] = 0;
+    // Validate hash length
+    if (!validate_hash_length(hash, &args))
+    {
+        size_t expected_len = args.digest_length * 2;
+        size_t actual_len = strlen(hash);
+        fprintf(stderr, "\nError: Hash length mismatch for algorithm '%s'.\n", args.name);
+        fprintf(stderr, "Expected %zu characters, got %zu.\n", expected_len, actual_len);
+        return -1;
+    }
 
-        // Skip empty lines and comments
-        if (strlen(line) == 0 || line[0] == '#')
+    if (strcasecmp(mode, "combinator") == 0)
+    {
+        if (operand_count != 2)
         {
-            continue;
+            fprintf(stderr, "\nError: Combinator mode expects 2 wordlists, got %d.\n", operand_count);
+            print_usage(program_name);
+            return -1;
         }
 
-        // Remove leading/trailing whitespace
-        char *hash = line;
-        while (isspace((unsigned char)*hash))
-            hash++;
+        for (int i = 0; i < operand_count; i++)
+        {
+            if (!validate_wordlist_file(operands[i]))
+            {
+                fprintf(stderr, "\nError: Cannot access wordlist file '%s'.\n", operands[i]);
+                fprintf(stderr, "Please check that the file exists and is readable.\n");
+                return -1;
+            }
+        }
 
-        char *end = hash + strlen(hash) - 1;
-        while (end > hash && isspace((unsigned char)*end))
-            end--;
-        end[1] = '\0';
+        printf("=== HashCrack CLI ===\n");
+        printf("Algorithm   : %s (id: %zu)\n", args.name, args.id);
+        printf("Target hash : %s\n", hash);
+        printf("Attack mode : combinator\n");
+        printf("Left list   : %s\n", operands[0]);
+        printf("Right list  : %s\n", operands[1]);
+        printf("=======================\n");
+        printf("Starting cracking process...\n");
+
+        return (crack_combinator(&args, hash, operands[0], operands[1]) == EXIT_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
-        // Skip if empty after trimming
-        if (strlen(hash) == 0)
+    bool word_first = (strcasecmp(mode, "hybrid-wm") == 0);
+    if (word_first || strcasecmp(mode, "hybrid-mw") == 0)
+    {
+        if (operand_count != 2)
         {
-            continue;
+            fprintf(stderr, "\nError: Hybrid mode expects a wordlist and a mask, got %d operands.\n", operand_count);
+            print_usage(program_name);
+            return -1;
         }
 
-        total_hashes++;
+        const char *wordlist_path = word_first ? operands[0] : operands[1];
+        const char *mask_string = word_first ? operands[1] : operands[0];
 
-        // Validate hash format
-        if (!validate_hash_format(hash))
+        if (!validate_wordlist_file(wordlist_path))
         {
-            fprintf(stderr, "Line %d: Invalid hash format '%s'\n", line_number, hash);
-            failed_hashes++;
-            continue;
+            fprintf(stderr, "\nError: Cannot access wordlist file '%s'.\n", wordlist_path);
+            fprintf(stderr, "Please check that the file exists and is readable.\n");
+            return -1;
         }
 
-        // Validate hash length
-        if (!validate_hash_length(hash, args))
+        Mask_t mask;
+        if (!parse_mask(mask_string, &mask))
         {
-            size_t expected_len = args->digest_length * 2;
-            size_t actual_len = strlen(hash);
-            fprintf(stderr, "Line %d: Hash length mismatch for algorithm '%s'. Expected %zu characters, got %zu\n",
-                    line_number, args->name, expected_len, actual_len);
-            failed_hashes++;
-            continue;
+            fprintf(stderr, "\nError: Invalid mask '%s'.\n", mask_string);
+            fprintf(stderr, "Use ?l ?u ?d ?s ?a placeholders, ?? for '?', other characters are literals.\n");
+            return -1;
+        }
+
+        printf("=== HashCrack CLI ===\n");
+        printf("Algorithm   : %s (id: %zu)\n", args.name, args.id);
+        printf("Target hash : %s\n", hash);
+        printf("Attack mode : %s\n", word_first ? "hybrid word + mask" : "hybrid mask + word");
+        printf("Wordlist    : %s\n", wordlist_path);
+        printf("Mask        : %s (%llu candidates per word)\n", mask_string, (unsigned long long)mask.keyspace);
+        printf("=======================\n");
+        printf("Starting cracking process...\n");
+
+        return (crack_hybrid(&args, hash, wordlist_path, mask_string, !word_first) == EXIT_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (strcasecmp(mode, "markov") == 0)
+    {
+        if (operand_count != 2)
+        {
+            fprintf(stderr, "\nError: Markov mode expects a training wordlist and a length, got %d operands.\n", operand_count);
+            print_usage(program_name);
+            return -1;
+        }
+
+        const char *training_path = operands[0];
+
+        // Length is either 'N' or 'MIN-MAX'
+        char *end;
+        unsigned long min_length = strtoul(operands[1], &end, 10);
+        unsigned long max_length = min_length;
+        if (*end == '-')
+        {
+            max_length = strtoul(end + 1, &end, 10);
+        }
+
+        if (*end != '\0' || min_length == 0 || min_length > max_length || max_length > MARKOV_MAX_LENGTH)
+        {
+            fprintf(stderr, "\nError: Invalid Markov length '%s'.\n", operands[1]);
+            fprintf(stderr, "Use a length (e.g. '8') or a range (e.g. '6-8') between 1 and %d.\n", MARKOV_MAX_LENGTH);
+            return -1;
+        }
+
+        if (!validate_wordlist_file(training_path))
+        {
+            fprintf(stderr, "\nError: Cannot access wordlist file '%s'.\n", training_path);
+            fprintf(stderr, "Please check that the file exists and is readable.\n");
+            return -1;
+        }
+
+        printf("=== HashCrack CLI ===\n");
+        printf("Algorithm   : %s (id: %zu)\n", args.name, args.id);
+        printf("Target hash : %s\n", hash);
+        printf("Attack mode : markov\n");
+        printf("Training    : %s\n", training_path);
+        printf("Length      : %lu-%lu\n", min_length, max_length);
+        printf("=======================\n");
+        printf("Training Markov table...\n");
+
+        MarkovTable_t *table = malloc(sizeof(MarkovTable_t));
+        if (table == NULL || !markov_train(training_path, table))
+        {
+            free(table);
+            return EXIT_FAILURE;
+        }
+
+        printf("Starting cracking process...\n");
+        int crack_result = crack_markov(&args, hash, table, (size_t)min_length, (size_t)max_length);
+        free(table);
+
+        return (crack_result == EXIT_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    fprintf(stderr, "\nError: Unknown attack mode '%s'.\n", mode);
+    print_usage(program_name);
+    return -1;
+}
+
+// Validate expression mode arguments and crack a hash or a hash file with chained-hash expressions
+int process_chain(int argc, char *argv[], const char *program_name)
+{
+    // Expression mode: ./hashcrack <EXPRESSIONS> <HASH> <WORDLIST_PATH>
+    //              or: ./hashcrack <EXPRESSIONS> -f <HASH_FILE> <WORDLIST_PATH>
+    bool file_mode = (argc == 5 && (strcmp(argv[2], "-f") == 0 || strcmp(argv[2], "--file") == 0));
+    if (!file_mode && argc != 4)
+    {
+        fprintf(stderr, "\nError: Expression mode expects '<EXPRESSIONS> <HASH> <WORDLIST_PATH>'\n");
+        fprintf(stderr, "or '<EXPRESSIONS> -f <HASH_FILE> <WORDLIST_PATH>'.\n");
+        print_usage(program_name);
+        return -1;
+    }
+
+    ChainPlan_t plan;
+    if (!chain_compile(argv[1], &plan))
+    {
+        fprintf(stderr, "Use '%s -l' to see the algorithms usable as functions.\n", program_name);
+        return -1;
+    }
+
+    const char *target = file_mode ? argv[3] : argv[2];
+    const char *wordlist_path = file_mode ? argv[4] : argv[3];
+    size_t digest_length = 0;
+
+    if (file_mode)
+    {
+        // Hashes of every expression's digest length are loaded from the file
+        if (!validate_hash_file(target))
+        {
+            fprintf(stderr, "\nError: Cannot access hash file '%s'.\n", target);
+            fprintf(stderr, "Please check that the file exists and is readable.\n");
+            return -1;
         }
+    }
+    else
+    {
+        size_t hash_len = strlen(target);
+        digest_length = hash_len / 2;
 
-        printf("Processing hash %d: %s\n", total_hashes, hash);
+        if (!validate_hash_format(target) || hash_len % 2 != 0)
+        {
+            fprintf(stderr, "\nError: Invalid hash format '%s'.\n", target);
+            fprintf(stderr, "Hash must be in hexadecimal format (e.g., '5f4dcc3b5aa765d61d8327deb882cf99').\n");
+            return -1;
+        }
 
-        // Attempt to crack the hash
-        int crack_result = crack_hash(args, hash, wordlist_path);
+        // Expressions with another digest length cannot match this hash
+        size_t matching = 0;
+        for (size_t i = 0; i < plan.expression_count; i++)
+        {
+            if (plan.expressions[i].digest_length == digest_length)
+            {
+                matching++;
+            }
+            else
+            {
+                fprintf(stderr, "Note: Skipping '%s', its digests are %zu characters long.\n",
+                        plan.expressions[i].text, plan.expressions[i].digest_length * 2);
+            }
+        }
 
-        if (crack_result == EXIT_SUCCESS)
+        if (matching == 0)
         {
-            cracked_hashes++;
+            fprintf(stderr, "\nError: No expression produces %zu-character hashes.\n", digest_length * 2);
+            return -1;
         }
-        else
+    }
+
+    if (!validate_wordlist_file(wordlist_path))
+    {
+        fprintf(stderr, "\nError: Cannot access wordlist file '%s'.\n", wordlist_path);
+        fprintf(stderr, "Please check that the file exists and is readable.\n");
+        return -1;
+    }
+
+    printf("=== HashCrack CLI ===\n");
+    for (size_t i = 0; i < plan.expression_count; i++)
+    {
+        if (file_mode || plan.expressions[i].digest_length == digest_length)
+        {
+            printf("Expression  : %s\n", plan.expressions[i].text);
+        }
+    }
+    printf("%s : %s\n", file_mode ? "Hash file  " : "Target hash", target);
+    printf("Wordlist    : %s\n", wordlist_path);
+    printf("=======================\n");
+    printf("Starting cracking process...\n");
+
+    if (file_mode)
+    {
+        // One target set per distinct digest length, all filled from a single read of the file
+        size_t digest_lengths[CHAIN_MAX_EXPRESSIONS];
+        size_t length_count = 0;
+
+        for (size_t i = 0; i < plan.expression_count; i++)
+        {
+            size_t j = 0;
+            while (j < length_count && digest_lengths[j] != plan.expressions[i].digest_length)
+                j++;
+
+            if (j == length_count)
+                digest_lengths[length_count++] = plan.expressions[i].digest_length;
+        }
+
+        TargetSet_t targets[CHAIN_MAX_EXPRESSIONS];
+        LoadStats_t stats;
+        if (!load_hash_file_lengths(target, digest_lengths, length_count, argv[1], targets, &stats))
+        {
+            return EXIT_FAILURE;
+        }
+
+        size_t loaded = 0;
+        for (size_t j = 0; j < length_count; j++)
+        {
+            loaded += targets[j].count;
+        }
+
+        printf("Loaded %zu unique hashes (%zu duplicates removed)\n", loaded, stats.duplicates);
+
+        size_t cracked_hashes = 0;
+        if (loaded > 0)
         {
-            printf("Hash not found in wordlist.\n");
+            cracked_hashes = chain_crack(&plan, targets, length_count, wordlist_path);
         }
 
         printf("\n");
+        for (size_t j = 0; j < length_count; j++)
+        {
+            free_targets(&targets[j]);
+        }
+
+        print_file_summary(&stats, cracked_hashes);
+        return (cracked_hashes > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-    fclose(hash_file);
+    // A single target is a set of one
+    unsigned char digest[digest_length];
+    bool cracked = false;
+    TargetSet_t targets = { digest, digest_length, 1, &cracked, 1 };
+    hex_to_digest(target, digest, digest_length);
 
-    // Print summary
-    printf("=== Summary ===\n");
-    printf("Total hashes processed: %d\n", total_hashes);
-    printf("Successfully cracked: %d\n", cracked_hashes);
-    printf("Failed to crack: %d\n", total_hashes - cracked_hashes);
-    printf("Invalid hashes: %d\n", failed_hashes);
-    printf("================\n");
+    printf("\n");
+    if (chain_crack(&plan, &targets, 1, wordlist_path) == 0)
+    {
+        printf("\nNo pass was found.\n");
+        return EXIT_FAILURE;
+    }
 
-    return (cracked_hashes > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    return EXIT_SUCCESS;
 }
 
 // Parse command-line arguments and handle options with robust validation
@@ -267,6 +581,21 @@ int parse_args(int argc, char *argv[], const char *program_name)
         }
     }
 
+    // Chained-hash expressions take the place of the algorithm name
+    if (argc >= 2 && is_chain_expression(argv[1]))
+    {
+        return process_chain(argc, argv, program_name);
+    }
+
+    // Check for attack mode (-a option)
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--attack") == 0)
+        {
+            return process_attack(argc, argv, i, program_name);
+        }
+    }
+
     // Check for file mode (-f option)
     bool file_mode = false;
     int file_option_index = -1;
@@ -313,6 +642,11 @@ int parse_args(int argc, char *argv[], const char *program_name)
         args.id = 0;
         args.digest_length = 0;
         args.alg = NULL;
+        args.crack = NULL;
+        args.crack_multi = NULL;
+        args.combine = NULL;
+        args.hybrid = NULL;
+        args.hash_batch = NULL;
 
         // Validate algorithm
         if (!validate_algorithm(alg_name, &args))
@@ -372,6 +706,11 @@ int parse_args(int argc, char *argv[], const char *program_name)
         args.id = 0;
         args.digest_length = 0;
         args.alg = NULL;
+        args.crack = NULL;
+        args.crack_multi = NULL;
+        args.combine = NULL;
+        args.hybrid = NULL;
+        args.hash_batch = NULL;
 
         // Validate algorithm
         if (!validate_algorithm(alg_name, &args))
@@ -408,6 +747,6 @@ int parse_args(int argc, char *argv[], const char *program_name)
         }
 
         // All validations passed for standard mode
-        return 0;
+        return STANDARD_MODE_READY;
     }
 }
\ No newline at end of file
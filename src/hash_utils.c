@@ -10,6 +10,8 @@
 #include <openssl/sha.h>
 #include <openssl/ripemd.h>
 #include "hash_utils.h"
+#include "fast_hash.h"
+#include "attack.h"
 #include "utils.h"
 
 // Helper functions for algorithms that need special handling
@@ -29,6 +31,93 @@ unsigned char *sha256_192_truncated(const unsigned char *input, size_t input_len
     return digest;
 }
 
+// Mark a target as cracked and print it with its password
+static void report_target(TargetSet_t *targets, size_t index, const char *password)
+{
+    char hex[targets->digest_length * 2 + 1];
+
+    targets->cracked[index] = true;
+    targets->remaining--;
+    hash_to_hex(targets->digests + index * targets->digest_length, targets->digest_length, hex);
+    printf("Found pass : %s (%s)\n", password, hex);
+}
+
+// Specialized crack loops, one per algorithm, generated from FAST_HASH_LIST
+// Each loop calls its hash kernel directly so the compiler can inline it,
+// and compares raw digests against the pre-decoded target
+#define DEFINE_CRACK_LOOP(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE)      \
+    static int crack_loop_##NAME(FILE *file, const unsigned char *target, char *found, size_t found_size) \
+    {                                                                                           \
+        char buffer[MAX_LENGTH];                                                                \
+        unsigned char digest[DIGEST_LENGTH];                                                    \
+        char *line;                                                                             \
+                                                                                                \
+        while ((line = read_line(file, buffer, MAX_LENGTH)))                                    \
+        {                                                                                       \
+            KERNEL((const unsigned char *)line, strlen(line), digest);                          \
+                                                                                                \
+            if (memcmp(digest, target, DIGEST_LENGTH) == 0)                                     \
+            {                                                                                   \
+                snprintf(found, found_size, "%s", line);                                        \
+                return EXIT_SUCCESS;                                                            \
+            }                                                                                   \
+        }                                                                                       \
+                                                                                                \
+        return -1;                                                                              \
+    }
+
+// Multi-target variant: every candidate is looked up in the sorted target set
+// and the loop ends once every target is cracked
+#define DEFINE_CRACK_MULTI_LOOP(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE) \
+    static size_t crack_multi_loop_##NAME(FILE *file, TargetSet_t *targets)                    \
+    {                                                                                           \
+        char buffer[MAX_LENGTH];                                                                \
+        unsigned char digest[DIGEST_LENGTH];                                                    \
+        size_t cracked = 0;                                                                     \
+        char *line;                                                                             \
+                                                                                                \
+        while (targets->remaining > 0 && (line = read_line(file, buffer, MAX_LENGTH)))          \
+        {                                                                                       \
+            KERNEL((const unsigned char *)line, strlen(line), digest);                          \
+                                                                                                \
+            size_t index = target_lookup(targets, digest);                                      \
+            if (index != SIZE_MAX && !targets->cracked[index])                                  \
+            {                                                                                   \
+                report_target(targets, index, line);                                            \
+                cracked++;                                                                      \
+            }                                                                                   \
+        }                                                                                       \
+                                                                                                \
+        return cracked;                                                                         \
+    }
+
+// Batch hash: hashes a block of candidates so callers can time or pipeline
+// the hash stage separately from reading and matching
+#define DEFINE_HASH_BATCH(NAME, KERNEL, DIGEST_LENGTH, CTX, INIT, UPDATE, FINAL, BLOCK_SIZE)    \
+    static void hash_batch_##NAME(const unsigned char *candidates, size_t stride,              \
+                                  const size_t *lengths, size_t count, unsigned char *digests)  \
+    {                                                                                           \
+        for (size_t i = 0; i < count; i++)                                                      \
+        {                                                                                       \
+            KERNEL(candidates + i * stride, lengths[i], digests + i * DIGEST_LENGTH);           \
+        }                                                                                       \
+    }
+
+FAST_HASH_LIST(DEFINE_CRACK_LOOP)
+FAST_HASH_LIST(DEFINE_CRACK_MULTI_LOOP)
+FAST_HASH_LIST(DEFINE_HASH_BATCH)
+
+#undef DEFINE_CRACK_LOOP
+#undef DEFINE_CRACK_MULTI_LOOP
+#undef DEFINE_HASH_BATCH
+
+// NTLM: MD4 over the UTF-16LE encoding of the input
+unsigned char *ntlm_hash(const unsigned char *input, size_t input_length, unsigned char *digest)
+{
+    fast_ntlm(input, input_length, digest);
+    return digest;
+}
+
 // Define supported hash algorithms
 
 const Hash_t MD5_alg = {
@@ -36,7 +125,12 @@ const Hash_t MD5_alg = {
     "MD5 Hash Algorithm",
     0,
     MD5_DIGEST_LENGTH,
-    MD5
+    MD5,
+    crack_loop_MD5,
+    crack_multi_loop_MD5,
+    combine_loop_MD5,
+    hybrid_loop_MD5,
+    hash_batch_MD5
 };
 
 const Hash_t MD4_alg = {
@@ -44,7 +138,12 @@ const Hash_t MD4_alg = {
     "MD4 Hash Algorithm",
     1,
     MD4_DIGEST_LENGTH,
-    MD4
+    MD4,
+    crack_loop_MD4,
+    crack_multi_loop_MD4,
+    combine_loop_MD4,
+    hybrid_loop_MD4,
+    hash_batch_MD4
 };
 
 const Hash_t RIPEMD160_alg = {
@@ -52,7 +151,12 @@ const Hash_t RIPEMD160_alg = {
     "RIPEMD160 Hash Algorithm",
     2,
     RIPEMD160_DIGEST_LENGTH,
-    RIPEMD160
+    RIPEMD160,
+    crack_loop_RIPEMD160,
+    crack_multi_loop_RIPEMD160,
+    combine_loop_RIPEMD160,
+    hybrid_loop_RIPEMD160,
+    hash_batch_RIPEMD160
 };
 
 const Hash_t SHA1_alg = {
@@ -60,7 +164,12 @@ const Hash_t SHA1_alg = {
     "SHA1 Hash Algorithm",
     3,
     SHA_DIGEST_LENGTH,
-    SHA1
+    SHA1,
+    crack_loop_SHA1,
+    crack_multi_loop_SHA1,
+    combine_loop_SHA1,
+    hybrid_loop_SHA1,
+    hash_batch_SHA1
 };
 
 const Hash_t SHA224_alg = {
@@ -68,7 +177,12 @@ const Hash_t SHA224_alg = {
     "SHA224 Hash Algorithm",
     4,
     SHA224_DIGEST_LENGTH,
-    SHA224
+    SHA224,
+    crack_loop_SHA224,
+    crack_multi_loop_SHA224,
+    combine_loop_SHA224,
+    hybrid_loop_SHA224,
+    hash_batch_SHA224
 };
 
 const Hash_t SHA256_alg = {
@@ -76,7 +190,12 @@ const Hash_t SHA256_alg = {
     "SHA256 Hash Algorithm",
     5,
     SHA256_DIGEST_LENGTH,
-    SHA256
+    SHA256,
+    crack_loop_SHA256,
+    crack_multi_loop_SHA256,
+    combine_loop_SHA256,
+    hybrid_loop_SHA256,
+    hash_batch_SHA256
 };
 
 const Hash_t SHA384_alg = {
@@ -84,7 +203,12 @@ const Hash_t SHA384_alg = {
     "SHA384 Hash Algorithm",
     6,
     SHA384_DIGEST_LENGTH,
-    SHA384
+    SHA384,
+    crack_loop_SHA384,
+    crack_multi_loop_SHA384,
+    combine_loop_SHA384,
+    hybrid_loop_SHA384,
+    hash_batch_SHA384
 };
 
 const Hash_t SHA512_alg = {
@@ -92,7 +216,12 @@ const Hash_t SHA512_alg = {
     "SHA512 Hash Algorithm",
     7,
     SHA512_DIGEST_LENGTH,
-    SHA512
+    SHA512,
+    crack_loop_SHA512,
+    crack_multi_loop_SHA512,
+    combine_loop_SHA512,
+    hybrid_loop_SHA512,
+    hash_batch_SHA512
 };
 
 const Hash_t MD5_SHA1_alg = {
@@ -100,7 +229,12 @@ const Hash_t MD5_SHA1_alg = {
     "MD5 followed by SHA1 Hash Algorithm",
     8,
     SHA_DIGEST_LENGTH,
-    md5_sha1_combined
+    md5_sha1_combined,
+    crack_loop_MD5_SHA1,
+    crack_multi_loop_MD5_SHA1,
+    combine_loop_MD5_SHA1,
+    hybrid_loop_MD5_SHA1,
+    hash_batch_MD5_SHA1
 };
 
 const Hash_t SHA256_192_alg = {
@@ -108,7 +242,25 @@ const Hash_t SHA256_192_alg = {
     "SHA256-192 (truncated) Hash Algorithm",
     9,
     24, // 192 bits = 24 bytes
-    sha256_192_truncated
+    sha256_192_truncated,
+    crack_loop_SHA256_192,
+    crack_multi_loop_SHA256_192,
+    combine_loop_SHA256_192,
+    hybrid_loop_SHA256_192,
+    hash_batch_SHA256_192
+};
+
+const Hash_t NTLM_alg = {
+    "NTLM",
+    "NTLM (MD4 over UTF-16LE) Hash Algorithm",
+    10,
+    MD4_DIGEST_LENGTH,
+    ntlm_hash,
+    crack_loop_NTLM,
+    crack_multi_loop_NTLM,
+    combine_loop_NTLM,
+    hybrid_loop_NTLM,
+    hash_batch_NTLM
 };
 
 // Array of supported algorithms
@@ -122,11 +274,24 @@ static Hash_t algs[] = {
     SHA384_alg,
     SHA512_alg,
     MD5_SHA1_alg,
-    SHA256_192_alg
+    SHA256_192_alg,
+    NTLM_alg
 };
 
 static const size_t num_algorithms = sizeof(algs) / sizeof(algs[0]);
 
+// Value of a single hexadecimal character, or -1 if invalid
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
 // Convert a hash digest (byte array) to a hexadecimal string
 void hash_to_hex(const unsigned char digest[], size_t digest_length, char *output)
 {
@@ -163,6 +328,25 @@ char *hash_generic(const char *input, HashFunc_t hash_alg, size_t digest_length,
     return output;
 }
 
+// Decode a hexadecimal string into a raw digest of the given length
+bool hex_to_digest(const char *hex, unsigned char *digest, size_t digest_length)
+{
+    for (size_t i = 0; i < digest_length; i++)
+    {
+        int high = hex_value(hex[i * 2]);
+        int low = (high < 0) ? -1 : hex_value(hex[i * 2 + 1]);
+
+        if (low < 0)
+        {
+            return false;
+        }
+
+        digest[i] = (unsigned char)((high << 4) | low);
+    }
+
+    return hex[digest_length * 2] == '\0';
+}
+
 // List all supported hash algorithms
 void list_algorithms()
 {
@@ -221,6 +405,11 @@ int set_args(Hash_t *alg, Hash_t *args)
     args -> id = alg -> id;
     args -> digest_length = alg -> digest_length;
     args -> alg = alg -> alg;
+    args -> crack = alg -> crack;
+    args -> crack_multi = alg -> crack_multi;
+    args -> combine = alg -> combine;
+    args -> hybrid = alg -> hybrid;
+    args -> hash_batch = alg -> hash_batch;
     
     return 0;
 }
@@ -241,25 +430,99 @@ int crack_hash(Hash_t *args, const char *hash, const char *wordlist)
         return EXIT_FAILURE;
     }
 
-    int size = MAX_LENGTH;
-    char buffer[size];
-    char output[(args -> digest_length) * 2 + 1];
-    char *line;
-    
-    // Read each line from the wordlist and hash it
-    while ((line = read_line(file, buffer, size)))
+    // Decode the target once so candidates are compared as raw digests
+    unsigned char target[args -> digest_length];
+    if (!hex_to_digest(hash, target, args -> digest_length))
     {
-        hash_generic(line, args -> alg, args -> digest_length, output);
+        fprintf(stderr, "\nInvalid target hash '%s' for algorithm '%s'.\n", hash, args -> name);
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    char found[MAX_LENGTH];
+    int result = -1;
 
-        // Compare the computed hash with the target hash (case-insensitive)
-        if (strcasecmp(hash, output) == 0)
+    if (args -> crack != NULL)
+    {
+        // Specialized loop for this algorithm
+        result = args -> crack(file, target, found, sizeof(found));
+    }
+    else
+    {
+        // Generic loop through the hash function pointer
+        char buffer[MAX_LENGTH];
+        unsigned char digest[args -> digest_length];
+        char *line;
+
+        while ((line = read_line(file, buffer, MAX_LENGTH)))
         {
-            printf("\nFound pass : %s\n", line);
-            fclose(file);
-            return EXIT_SUCCESS;
+            args -> alg((const unsigned char *)line, strlen(line), digest);
+
+            if (memcmp(digest, target, args -> digest_length) == 0)
+            {
+                snprintf(found, sizeof(found), "%s", line);
+                result = EXIT_SUCCESS;
+                break;
+            }
         }
     }
 
+    fclose(file);
+
+    if (result == EXIT_SUCCESS)
+    {
+        printf("\nFound pass : %s\n", found);
+        return EXIT_SUCCESS;
+    }
+
     printf("\nNo pass was found.\n");
     return -1;
+}
+
+
+// Attempt to crack every hash of a target set in a single wordlist pass
+size_t crack_targets(Hash_t *args, TargetSet_t *targets, const char *wordlist)
+{
+    if (args == NULL || targets == NULL)
+    {
+        fprintf(stderr, "\nHash structure is NULL, can't crack hash.\n");
+        return 0;
+    }
+
+    FILE *file = fopen(wordlist, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error opening file '%s': %s\n", wordlist, strerror(errno));
+        return 0;
+    }
+
+    size_t cracked = 0;
+
+    if (args -> crack_multi != NULL)
+    {
+        // Specialized loop for this algorithm
+        cracked = args -> crack_multi(file, targets);
+    }
+    else
+    {
+        // Generic loop through the hash function pointer
+        char buffer[MAX_LENGTH];
+        unsigned char digest[args -> digest_length];
+        char *line;
+
+        while (targets -> remaining > 0 && (line = read_line(file, buffer, MAX_LENGTH)))
+        {
+            args -> alg((const unsigned char *)line, strlen(line), digest);
+
+            size_t index = target_lookup(targets, digest);
+            if (index != SIZE_MAX && !targets -> cracked[index])
+            {
+                report_target(targets, index, line);
+                cracked++;
+            }
+        }
+    }
+
+    fclose(file);
+    return cracked;
 }
\ No newline at end of file
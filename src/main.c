@@ -2,8 +2,11 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include "cli.h"
 #include "utils.h"
+#include "profile.h"
 
 // Banner to display at program start
 const char *banner =
@@ -22,6 +25,22 @@ int main(int argc, char *argv[])
     printf("%s\n\n", banner);
     const char *name = argv[0];
 
+    // Take --profile out of the arguments, it applies to standard mode only
+    bool profile = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--profile") == 0)
+        {
+            profile = true;
+            for (int j = i; j < argc - 1; j++)
+            {
+                argv[j] = argv[j + 1];
+            }
+            argc--;
+            i--;
+        }
+    }
+
     // Parse and validate command-line arguments
     int result = parse_args(argc, argv, name);
 
@@ -32,11 +51,16 @@ int main(int argc, char *argv[])
     }
     else if (result == EXIT_SUCCESS || result == EXIT_FAILURE)
     {
+        if (profile)
+        {
+            fprintf(stderr, "Note: --profile only applies to standard mode.\n");
+        }
+
         // File mode was processed directly by parse_args
         // Return the result from file processing
         return result;
     }
-    else if (result != 0)
+    else if (result != STANDARD_MODE_READY)
     {
         // Validation failed, exit with error
         return EXIT_FAILURE;
@@ -55,6 +79,11 @@ int main(int argc, char *argv[])
     args.id = 0;
     args.digest_length = 0;
     args.alg = NULL;
+    args.crack = NULL;
+    args.crack_multi = NULL;
+    args.combine = NULL;
+    args.hybrid = NULL;
+    args.hash_batch = NULL;
 
     // Get algorithm details (this should succeed since we validated it)
     size_t result_id = get_alg_id(alg_name, &args);
@@ -71,8 +100,8 @@ int main(int argc, char *argv[])
     printf("=======================\n");
     printf("Starting cracking process...\n");
 
-    // Attempt to crack the hash
-    int crack_result = crack_hash(&args, hash, wordlist);
+    // Attempt to crack the hash, with a per-stage breakdown if requested
+    int crack_result = profile ? crack_hash_profile(&args, hash, wordlist) : crack_hash(&args, hash, wordlist);
 
     if (crack_result == EXIT_SUCCESS)
     {
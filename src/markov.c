@@ -0,0 +1,551 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include "markov.h"
+#include "utils.h"
+
+#define MARKOV_BATCH 1024 // Candidates hashed per batch
+
+// Quantized cost of an event seen 'count' times out of 'total', with add-one smoothing over 'outcomes'
+// Roughly -log2 of the probability, rounded up and capped to MARKOV_LEVELS - 1
+static uint8_t quantize_cost(uint64_t count, uint64_t total, uint64_t outcomes)
+{
+    uint64_t smoothed_count = count + 1;
+    uint64_t smoothed_total = total + outcomes;
+    uint8_t cost = 0;
+
+    while ((smoothed_count << cost) < smoothed_total && cost < MARKOV_LEVELS - 1)
+    {
+        cost++;
+    }
+
+    return cost;
+}
+
+// Train the table from a wordlist
+bool markov_train(const char *wordlist, MarkovTable_t *table)
+{
+    FILE *file = fopen(wordlist, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error opening file '%s': %s\n", wordlist, strerror(errno));
+        return false;
+    }
+
+    // counts[position][previous][next], with an extra total column per row
+    uint32_t (*counts)[MARKOV_CHARSET + 1][MARKOV_CHARSET + 1] =
+        calloc(MARKOV_MAX_LENGTH, sizeof(*counts));
+    if (counts == NULL)
+    {
+        fprintf(stderr, "\nMemory allocation failed in markov_train.\n");
+        fclose(file);
+        return false;
+    }
+
+    uint64_t length_counts[MARKOV_MAX_LENGTH + 1] = { 0 };
+    uint64_t words = 0;
+    char buffer[MAX_WORD_LENGTH];
+    char *line;
+
+    while ((line = read_line(file, buffer, MAX_WORD_LENGTH)))
+    {
+        size_t length = strlen(line);
+        if (length == 0 || length > MARKOV_MAX_LENGTH)
+            continue;
+
+        bool printable = true;
+        for (size_t i = 0; i < length && printable; i++)
+            printable = (line[i] >= 0x20 && line[i] <= 0x7e);
+        if (!printable)
+            continue;
+
+        size_t previous = MARKOV_START;
+        for (size_t i = 0; i < length; i++)
+        {
+            size_t next = (size_t)(line[i] - 0x20);
+            counts[i][previous][next]++;
+            counts[i][previous][MARKOV_CHARSET]++;
+            previous = next;
+        }
+
+        length_counts[length]++;
+        words++;
+    }
+
+    fclose(file);
+
+    for (size_t length = 0; length <= MARKOV_MAX_LENGTH; length++)
+    {
+        table->length_cost[length] = quantize_cost(length_counts[length], words, MARKOV_MAX_LENGTH);
+    }
+
+    for (size_t position = 0; position < MARKOV_MAX_LENGTH; position++)
+    {
+        for (size_t previous = 0; previous <= MARKOV_CHARSET; previous++)
+        {
+            uint8_t *costs = table->cost[position][previous];
+            uint8_t *order = table->order[position][previous];
+            uint32_t total = counts[position][previous][MARKOV_CHARSET];
+
+            for (size_t next = 0; next < MARKOV_CHARSET; next++)
+            {
+                costs[next] = quantize_cost(counts[position][previous][next], total, MARKOV_CHARSET);
+            }
+
+            // Insertion sort of the next characters by cost, ties by character value
+            for (size_t i = 0; i < MARKOV_CHARSET; i++)
+            {
+                size_t j = i;
+                while (j > 0 && costs[order[j - 1]] > costs[i])
+                {
+                    order[j] = order[j - 1];
+                    j--;
+                }
+                order[j] = (uint8_t)i;
+            }
+        }
+    }
+
+    free(counts);
+    return true;
+}
+
+// Two-character prefix of the candidates of one length at the current level
+// The levels are split into these, so even the cheapest levels spread over every thread
+typedef struct
+{
+    uint8_t length;
+    uint8_t first;                  // Character indexes, 0 is ' '
+    uint8_t second;                 // Unused for length 1
+    uint8_t budget;                 // Cost left for the characters after the prefix
+} MarkovPrefix_t;
+
+#define MARKOV_MAX_PREFIXES (MARKOV_MAX_LENGTH * MARKOV_CHARSET * MARKOV_CHARSET)
+#define MARKOV_CLAIMS_PER_THREAD 64 // Claims per thread and level, small so uneven prefixes balance out
+
+// State shared by the Markov worker pool
+// The pool threads are started once per run. For each level the calling thread publishes
+// the prefixes fitting its budget, then drains them with the pool
+typedef struct
+{
+    const Hash_t *args;
+    const unsigned char *target;
+    const MarkovTable_t *table;
+    pthread_mutex_t lock;
+    pthread_cond_t level_ready;     // A level was published or the run is over
+    pthread_cond_t level_done;      // Every pool thread is done with the current level
+    unsigned long generation;       // Levels published so far
+    size_t busy;                    // Pool threads still working on the current level
+    bool finished;
+    MarkovPrefix_t *prefixes;       // Prefixes of the current level
+    size_t prefix_count;
+    size_t claim;                   // Prefixes claimed at once by a worker
+    size_t next;                    // First unclaimed prefix, updated atomically
+    int stop;                       // See stop_requested
+    bool found;
+    char found_word[MARKOV_MAX_LENGTH + 1];
+} MarkovPool_t;
+
+// State of one Markov thread
+typedef struct
+{
+    MarkovPool_t *pool;
+    size_t length;                  // Length being enumerated
+    unsigned char candidate[MARKOV_MAX_LENGTH];
+    unsigned char (*batch)[MARKOV_MAX_LENGTH];
+    size_t lengths[MARKOV_BATCH];
+    unsigned char *digests;
+    size_t batch_count;
+    uint64_t tried;
+} MarkovWorker_t;
+
+// Hash and check the pending candidates
+static void flush_batch(MarkovWorker_t *worker)
+{
+    MarkovPool_t *pool = worker->pool;
+    const Hash_t *args = pool->args;
+
+    if (args->hash_batch != NULL)
+    {
+        args->hash_batch((const unsigned char *)worker->batch, MARKOV_MAX_LENGTH, worker->lengths,
+                         worker->batch_count, worker->digests);
+    }
+    else
+    {
+        for (size_t i = 0; i < worker->batch_count; i++)
+        {
+            args->alg(worker->batch[i], worker->lengths[i], worker->digests + i * args->digest_length);
+        }
+    }
+
+    for (size_t i = 0; i < worker->batch_count; i++)
+    {
+        if (memcmp(worker->digests + i * args->digest_length, pool->target, args->digest_length) == 0)
+        {
+            pthread_mutex_lock(&pool->lock);
+            if (!pool->found)
+            {
+                memcpy(pool->found_word, worker->batch[i], worker->lengths[i]);
+                pool->found_word[worker->lengths[i]] = '\0';
+                pool->found = true;
+            }
+            pthread_mutex_unlock(&pool->lock);
+            request_stop(&pool->stop);
+            break;
+        }
+    }
+
+    worker->tried += worker->batch_count;
+    worker->batch_count = 0;
+}
+
+static void emit_candidate(MarkovWorker_t *worker)
+{
+    memcpy(worker->batch[worker->batch_count], worker->candidate, worker->length);
+    worker->lengths[worker->batch_count] = worker->length;
+
+    if (++worker->batch_count == MARKOV_BATCH)
+    {
+        flush_batch(worker);
+    }
+}
+
+// Enumerate every completion of the candidate from 'position' whose cost is exactly 'budget'
+static void markov_walk(MarkovWorker_t *worker, size_t position, size_t previous, unsigned int budget)
+{
+    // Even the most expensive characters could not spend the budget
+    if (budget > (worker->length - position) * (MARKOV_LEVELS - 1) || stop_requested(&worker->pool->stop))
+    {
+        return;
+    }
+
+    const uint8_t *costs = worker->pool->table->cost[position][previous];
+    const uint8_t *order = worker->pool->table->order[position][previous];
+    bool last = (position + 1 == worker->length);
+
+    for (size_t i = 0; i < MARKOV_CHARSET; i++)
+    {
+        size_t next = order[i];
+        unsigned int cost = costs[next];
+        if (cost > budget)
+            break;
+
+        worker->candidate[position] = (unsigned char)(next + 0x20);
+
+        if (!last)
+            markov_walk(worker, position + 1, next, budget - cost);
+        else if (cost == budget)
+            emit_candidate(worker);
+    }
+}
+
+// List the prefixes of every length whose cost fits 'level', returns their number
+static size_t markov_prefixes(const MarkovTable_t *table, unsigned int level, size_t min_length, size_t max_length,
+                              MarkovPrefix_t *prefixes)
+{
+    size_t count = 0;
+
+    for (size_t length = min_length; length <= max_length; length++)
+    {
+        unsigned int length_cost = table->length_cost[length];
+        if (length_cost > level || level - length_cost > length * (MARKOV_LEVELS - 1))
+            continue;
+
+        unsigned int budget = level - length_cost;
+        const uint8_t *costs = table->cost[0][MARKOV_START];
+        const uint8_t *order = table->order[0][MARKOV_START];
+
+        for (size_t i = 0; i < MARKOV_CHARSET && costs[order[i]] <= budget; i++)
+        {
+            size_t first = order[i];
+            unsigned int first_budget = budget - costs[first];
+
+            if (length == 1)
+            {
+                if (first_budget == 0)
+                    prefixes[count++] = (MarkovPrefix_t){ 1, (uint8_t)first, 0, 0 };
+                continue;
+            }
+
+            const uint8_t *second_costs = table->cost[1][first];
+            const uint8_t *second_order = table->order[1][first];
+
+            for (size_t j = 0; j < MARKOV_CHARSET && second_costs[second_order[j]] <= first_budget; j++)
+            {
+                size_t second = second_order[j];
+                unsigned int rest = first_budget - second_costs[second];
+
+                // The remaining characters must be able to spend exactly what is left
+                if (rest > (length - 2) * (MARKOV_LEVELS - 1))
+                    continue;
+
+                prefixes[count++] = (MarkovPrefix_t){ (uint8_t)length, (uint8_t)first, (uint8_t)second, (uint8_t)rest };
+            }
+        }
+    }
+
+    return count;
+}
+
+// Claim the next prefixes of the current level, returns false once they are exhausted
+static bool claim_prefixes(MarkovPool_t *pool, size_t *start, size_t *end)
+{
+    size_t index = __atomic_load_n(&pool->next, __ATOMIC_RELAXED);
+    size_t count;
+
+    do
+    {
+        if (index >= pool->prefix_count)
+            return false;
+
+        count = pool->prefix_count - index;
+        if (count > pool->claim)
+            count = pool->claim;
+    } while (!__atomic_compare_exchange_n(&pool->next, &index, index + count, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    *start = index;
+    *end = index + count;
+    return true;
+}
+
+// Enumerate claimed prefixes of the current level until it is exhausted or the password is found
+static void markov_drain(MarkovWorker_t *worker)
+{
+    MarkovPool_t *pool = worker->pool;
+    size_t index;
+    size_t end;
+
+    while (!stop_requested(&pool->stop) && claim_prefixes(pool, &index, &end))
+    {
+        for (; index < end; index++)
+        {
+            const MarkovPrefix_t *prefix = &pool->prefixes[index];
+
+            worker->length = prefix->length;
+            worker->candidate[0] = (unsigned char)(prefix->first + 0x20);
+
+            if (prefix->length == 1)
+            {
+                emit_candidate(worker);
+                continue;
+            }
+
+            worker->candidate[1] = (unsigned char)(prefix->second + 0x20);
+
+            if (prefix->length == 2)
+                emit_candidate(worker);
+            else
+                markov_walk(worker, 2, prefix->second, prefix->budget);
+        }
+    }
+
+    // Levels are checked in order, nothing is left pending for the next one
+    if (worker->batch_count > 0 && !stop_requested(&pool->stop))
+    {
+        flush_batch(worker);
+    }
+    worker->batch_count = 0;
+}
+
+// Pool thread entry point: drain every published level until the run is over
+static void *markov_thread(void *arg)
+{
+    MarkovWorker_t *worker = arg;
+    MarkovPool_t *pool = worker->pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (pool->generation == seen && !pool->finished)
+        {
+            pthread_cond_wait(&pool->level_ready, &pool->lock);
+        }
+        if (pool->finished)
+        {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        markov_drain(worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0)
+        {
+            pthread_cond_signal(&pool->level_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+// Attempt to crack the hash with candidates in increasing cost (decreasing probability) order
+// Each cost level is enumerated completely, split across the pool by prefix, before the next one
+int crack_markov(Hash_t *args, const char *hash, const MarkovTable_t *table, size_t min_length, size_t max_length)
+{
+    if (args == NULL || table == NULL)
+    {
+        fprintf(stderr, "\nHash structure is NULL, can't crack hash.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (min_length == 0 || min_length > max_length || max_length > MARKOV_MAX_LENGTH)
+    {
+        fprintf(stderr, "\nInvalid Markov length range %zu-%zu (1 to %d).\n", min_length, max_length, MARKOV_MAX_LENGTH);
+        return EXIT_FAILURE;
+    }
+
+    unsigned char target[args->digest_length];
+    if (!hex_to_digest(hash, target, args->digest_length))
+    {
+        fprintf(stderr, "\nInvalid target hash '%s' for algorithm '%s'.\n", hash, args->name);
+        return EXIT_FAILURE;
+    }
+
+    size_t threads = thread_count();
+    MarkovWorker_t *workers = calloc(threads, sizeof(MarkovWorker_t));
+    MarkovPrefix_t *prefixes = malloc(MARKOV_MAX_PREFIXES * sizeof(MarkovPrefix_t));
+    bool ok = (workers != NULL && prefixes != NULL);
+
+    for (size_t t = 0; ok && t < threads; t++)
+    {
+        workers[t].batch = malloc(MARKOV_BATCH * sizeof(*workers[t].batch));
+        workers[t].digests = malloc(MARKOV_BATCH * args->digest_length);
+        ok = (workers[t].batch != NULL && workers[t].digests != NULL);
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "\nMemory allocation failed in crack_markov.\n");
+        for (size_t t = 0; workers != NULL && t < threads; t++)
+        {
+            free(workers[t].batch);
+            free(workers[t].digests);
+        }
+        free(workers);
+        free(prefixes);
+        return EXIT_FAILURE;
+    }
+
+    MarkovPool_t pool;
+    pool.args = args;
+    pool.target = target;
+    pool.table = table;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.level_ready, NULL);
+    pthread_cond_init(&pool.level_done, NULL);
+    pool.generation = 0;
+    pool.busy = 0;
+    pool.finished = false;
+    pool.prefixes = prefixes;
+    pool.prefix_count = 0;
+    pool.claim = 1;
+    pool.next = 0;
+    pool.stop = 0;
+    pool.found = false;
+
+    for (size_t t = 0; t < threads; t++)
+    {
+        workers[t].pool = &pool;
+    }
+
+    // The calling thread is a worker too (workers[0]), the pool holds the others
+    pthread_t thread_ids[MAX_THREADS];
+    size_t started = 1;
+    for (; started < threads; started++)
+    {
+        if (pthread_create(&thread_ids[started], NULL, markov_thread, &workers[started]) != 0)
+        {
+            break;
+        }
+    }
+
+    // Highest cost any candidate can have; the full keyspace is covered once it is reached
+    unsigned int max_level = 0;
+    for (size_t length = min_length; length <= max_length; length++)
+    {
+        unsigned int level = table->length_cost[length] + (unsigned int)length * (MARKOV_LEVELS - 1);
+        if (level > max_level)
+            max_level = level;
+    }
+
+    unsigned int found_level = 0;
+    uint64_t tried = 0;
+
+    for (unsigned int level = 0; level <= max_level && !stop_requested(&pool.stop); level++)
+    {
+        size_t count = markov_prefixes(table, level, min_length, max_length, prefixes);
+        if (count == 0)
+            continue;
+
+        size_t claim = count / (started * MARKOV_CLAIMS_PER_THREAD);
+
+        // Hand the level to the pool
+        pthread_mutex_lock(&pool.lock);
+        pool.prefix_count = count;
+        pool.claim = (claim == 0) ? 1 : claim;
+        __atomic_store_n(&pool.next, 0, __ATOMIC_RELAXED);
+        pool.busy = started - 1;
+        pool.generation++;
+        pthread_cond_broadcast(&pool.level_ready);
+        pthread_mutex_unlock(&pool.lock);
+
+        markov_drain(&workers[0]);
+
+        pthread_mutex_lock(&pool.lock);
+        while (pool.busy > 0)
+        {
+            pthread_cond_wait(&pool.level_done, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+
+        found_level = level;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.finished = true;
+    pthread_cond_broadcast(&pool.level_ready);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (size_t t = 1; t < started; t++)
+    {
+        pthread_join(thread_ids[t], NULL);
+    }
+
+    pthread_cond_destroy(&pool.level_done);
+    pthread_cond_destroy(&pool.level_ready);
+    pthread_mutex_destroy(&pool.lock);
+
+    const char *found = pool.found ? pool.found_word : NULL;
+
+    for (size_t t = 0; t < threads; t++)
+    {
+        tried += workers[t].tried;
+    }
+
+    if (found != NULL)
+    {
+        printf("\nFound pass : %s\n", found);
+        printf("Cost level %u, %llu candidates tried\n", found_level, (unsigned long long)tried);
+    }
+    else
+    {
+        printf("\nNo pass was found (%llu candidates tried).\n", (unsigned long long)tried);
+    }
+
+    int result = (found != NULL) ? EXIT_SUCCESS : -1;
+
+    for (size_t t = 0; t < threads; t++)
+    {
+        free(workers[t].batch);
+        free(workers[t].digests);
+    }
+    free(workers);
+    free(prefixes);
+
+    return result;
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <string.h>
+#include "mask.h"
+
+// Built-in charsets
+static const char charset_lower[] = "abcdefghijklmnopqrstuvwxyz";
+static const char charset_upper[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+static const char charset_digit[] = "0123456789";
+static const char charset_symbol[] = " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+static const char charset_all[] =
+    "abcdefghijklmnopqrstuvwxyz"
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "0123456789"
+    " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+
+// Parse a mask string into per-position charsets
+bool parse_mask(const char *mask_string, Mask_t *mask)
+{
+    if (mask_string == NULL || mask == NULL)
+    {
+        return false;
+    }
+
+    mask->length = 0;
+    mask->keyspace = 1;
+
+    for (const char *p = mask_string; *p != '\0'; p++)
+    {
+        if (mask->length == MAX_MASK_LENGTH)
+        {
+            fprintf(stderr, "Mask is longer than %d positions.\n", MAX_MASK_LENGTH);
+            return false;
+        }
+
+        char *charset = mask->charsets[mask->length];
+
+        if (*p == '?')
+        {
+            p++;
+            switch (*p)
+            {
+                case 'l': strcpy(charset, charset_lower); break;
+                case 'u': strcpy(charset, charset_upper); break;
+                case 'd': strcpy(charset, charset_digit); break;
+                case 's': strcpy(charset, charset_symbol); break;
+                case 'a': strcpy(charset, charset_all); break;
+                case '?': strcpy(charset, "?"); break;
+                default:
+                    fprintf(stderr, "Unknown mask placeholder '?%c'.\n", *p ? *p : ' ');
+                    return false;
+            }
+        }
+        else
+        {
+            charset[0] = *p;
+            charset[1] = '\0';
+        }
+
+        size_t size = strlen(charset);
+
+        // Guard against keyspace overflow
+        if (mask->keyspace > UINT64_MAX / size)
+        {
+            fprintf(stderr, "Mask keyspace is too large.\n");
+            return false;
+        }
+
+        mask->sizes[mask->length] = size;
+        mask->keyspace *= size;
+        mask->length++;
+    }
+
+    return mask->length > 0;
+}
+
+// Set the odometer to candidate 'index' (last position varies fastest)
+void mask_seek(const Mask_t *mask, uint64_t index, size_t positions[], unsigned char *output)
+{
+    for (size_t i = mask->length; i > 0; i--)
+    {
+        size_t size = mask->sizes[i - 1];
+        positions[i - 1] = (size_t)(index % size);
+        output[i - 1] = (unsigned char)mask->charsets[i - 1][positions[i - 1]];
+        index /= size;
+    }
+}
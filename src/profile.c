@@ -0,0 +1,337 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include "profile.h"
+#include "utils.h"
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define PROFILE_BATCH 4096 // Candidates per read/hash/match round
+
+static const char *phase_names[PHASE_COUNT] = { "read", "hash", "match" };
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Lightweight timer: time stamp counter on x86, monotonic clock elsewhere
+// Ticks are converted to time in profile_report against the monotonic clock
+static inline uint64_t read_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint64_t)__rdtsc();
+#else
+    return monotonic_ns();
+#endif
+}
+
+#ifdef __linux__
+static int open_counter(uint64_t config, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0UL);
+}
+#endif
+
+// Read the current value of every counter of the group
+static bool read_counters(const Profile_t *profile, uint64_t values[COUNTER_COUNT])
+{
+    uint64_t buffer[1 + COUNTER_COUNT];
+    size_t expected = (1 + profile->counters_open) * sizeof(uint64_t);
+
+    if (profile->group_fd < 0 || read(profile->group_fd, buffer, expected) != (ssize_t)expected)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        int index = profile->counter_index[i];
+        values[i] = (index >= 0) ? buffer[1 + index] : 0;
+    }
+
+    return true;
+}
+
+// Open the hardware counters, falling back to timers only when they are unavailable
+void profile_open(Profile_t *profile)
+{
+    memset(profile, 0, sizeof(Profile_t));
+    profile->group_fd = -1;
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        profile->fds[i] = -1;
+        profile->counter_index[i] = -1;
+    }
+
+#ifdef __linux__
+    static const uint64_t configs[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    int first_error = 0;
+
+    // The first counter that opens leads the group, so all are read with one syscall
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        int fd = open_counter(configs[i], profile->group_fd);
+        if (fd < 0)
+        {
+            if (first_error == 0)
+                first_error = errno;
+            continue;
+        }
+
+        if (profile->group_fd < 0)
+            profile->group_fd = fd;
+        profile->fds[i] = fd;
+        profile->counter_index[i] = (int)profile->counters_open++;
+    }
+
+    if (profile->group_fd < 0)
+    {
+        snprintf(profile->unavailable, sizeof(profile->unavailable), "perf_event_open failed: %s",
+                 strerror(first_error));
+    }
+    else
+    {
+        ioctl(profile->group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(profile->group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    snprintf(profile->unavailable, sizeof(profile->unavailable), "hardware counters need Linux perf events");
+#endif
+
+    profile->run_start_ns = monotonic_ns();
+    profile->run_start_ticks = read_ticks();
+}
+
+void profile_close(Profile_t *profile)
+{
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        if (profile->fds[i] >= 0)
+        {
+            close(profile->fds[i]);
+            profile->fds[i] = -1;
+        }
+    }
+    profile->group_fd = -1;
+}
+
+// Start measuring a phase
+void profile_begin(Profile_t *profile)
+{
+    if (profile->group_fd >= 0)
+    {
+        read_counters(profile, profile->start_counters);
+    }
+    profile->start_ticks = read_ticks();
+}
+
+// Stop measuring and add the elapsed time and counter deltas to 'phase'
+void profile_end(Profile_t *profile, Phase_t phase)
+{
+    profile->ticks[phase] += read_ticks() - profile->start_ticks;
+
+    uint64_t values[COUNTER_COUNT];
+    if (profile->group_fd >= 0 && read_counters(profile, values))
+    {
+        for (size_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            profile->counters[phase][i] += values[i] - profile->start_counters[i];
+        }
+    }
+}
+
+static void print_counter(FILE *out, const Profile_t *profile, uint64_t value, Counter_t counter)
+{
+    if (profile->counter_index[counter] < 0)
+        fprintf(out, " %14s", "-");
+    else
+        fprintf(out, " %14llu", (unsigned long long)value);
+}
+
+// Print the per-phase breakdown since profile_open
+void profile_report(const Profile_t *profile, FILE *out)
+{
+    uint64_t wall_ns = monotonic_ns() - profile->run_start_ns;
+    uint64_t wall_ticks = read_ticks() - profile->run_start_ticks;
+    double ns_per_tick = wall_ticks ? (double)wall_ns / (double)wall_ticks : 0.0;
+
+    uint64_t total_ticks = 0;
+    uint64_t totals[COUNTER_COUNT] = { 0 };
+    for (size_t p = 0; p < PHASE_COUNT; p++)
+    {
+        total_ticks += profile->ticks[p];
+        for (size_t i = 0; i < COUNTER_COUNT; i++)
+            totals[i] += profile->counters[p][i];
+    }
+
+    fprintf(out, "\n=== Profile ===\n");
+    fprintf(out, "Candidates  : %llu\n", (unsigned long long)profile->candidates);
+    fprintf(out, "Wall time   : %.3f ms", (double)wall_ns / 1e6);
+    if (wall_ns > 0)
+        fprintf(out, " (%.0f candidates/s)", (double)profile->candidates * 1e9 / (double)wall_ns);
+    fprintf(out, "\n");
+    if (profile->unavailable[0] != '\0')
+        fprintf(out, "Counters    : unavailable (%s), timers only\n", profile->unavailable);
+
+    fprintf(out, "\n%-6s %10s %7s %14s %14s %6s %14s %14s\n",
+            "Phase", "Time (ms)", "Share", "Cycles", "Instructions", "IPC", "Cache misses", "Branch misses");
+
+    for (size_t p = 0; p <= PHASE_COUNT; p++)
+    {
+        bool total = (p == PHASE_COUNT);
+        uint64_t ticks = total ? total_ticks : profile->ticks[p];
+        const uint64_t *values = total ? totals : profile->counters[p];
+        double share = total_ticks ? (double)ticks * 100.0 / (double)total_ticks : 0.0;
+
+        fprintf(out, "%-6s %10.3f %6.1f%%", total ? "total" : phase_names[p],
+                (double)ticks * ns_per_tick / 1e6, share);
+        print_counter(out, profile, values[COUNTER_CYCLES], COUNTER_CYCLES);
+        print_counter(out, profile, values[COUNTER_INSTRUCTIONS], COUNTER_INSTRUCTIONS);
+
+        if (profile->counter_index[COUNTER_CYCLES] >= 0 && profile->counter_index[COUNTER_INSTRUCTIONS] >= 0 &&
+            values[COUNTER_CYCLES] > 0)
+            fprintf(out, " %6.2f", (double)values[COUNTER_INSTRUCTIONS] / (double)values[COUNTER_CYCLES]);
+        else
+            fprintf(out, " %6s", "-");
+
+        print_counter(out, profile, values[COUNTER_CACHE_MISSES], COUNTER_CACHE_MISSES);
+        print_counter(out, profile, values[COUNTER_BRANCH_MISSES], COUNTER_BRANCH_MISSES);
+        fprintf(out, "\n");
+    }
+}
+
+// Wordlist attack split into read, hash and match rounds of PROFILE_BATCH candidates,
+// so each stage is measured as a whole instead of per candidate
+int crack_hash_profile(Hash_t *args, const char *hash, const char *wordlist)
+{
+    if (args == NULL)
+    {
+        fprintf(stderr, "\nHash structure is NULL, can't crack hash.\n");
+        return EXIT_FAILURE;
+    }
+
+    unsigned char target[args->digest_length];
+    if (!hex_to_digest(hash, target, args->digest_length))
+    {
+        fprintf(stderr, "\nInvalid target hash '%s' for algorithm '%s'.\n", hash, args->name);
+        return EXIT_FAILURE;
+    }
+
+    FILE *file = fopen(wordlist, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error opening file '%s': %s\n", wordlist, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    char (*candidates)[MAX_LENGTH] = malloc(PROFILE_BATCH * sizeof(*candidates));
+    size_t *lengths = malloc(PROFILE_BATCH * sizeof(size_t));
+    unsigned char *digests = malloc(PROFILE_BATCH * args->digest_length);
+    if (candidates == NULL || lengths == NULL || digests == NULL)
+    {
+        fprintf(stderr, "\nMemory allocation failed in crack_hash_profile.\n");
+        free(candidates);
+        free(lengths);
+        free(digests);
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    Profile_t profile;
+    profile_open(&profile);
+
+    size_t found = SIZE_MAX;
+    size_t count;
+
+    do
+    {
+        // Read stage
+        profile_begin(&profile);
+        count = 0;
+        while (count < PROFILE_BATCH && read_line(file, candidates[count], MAX_LENGTH))
+        {
+            lengths[count] = strlen(candidates[count]);
+            count++;
+        }
+        profile_end(&profile, PHASE_READ);
+
+        // Hash stage
+        profile_begin(&profile);
+        if (args->hash_batch != NULL)
+        {
+            args->hash_batch((const unsigned char *)candidates, MAX_LENGTH, lengths, count, digests);
+        }
+        else
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                args->alg((const unsigned char *)candidates[i], lengths[i], digests + i * args->digest_length);
+            }
+        }
+        profile_end(&profile, PHASE_HASH);
+
+        // Match stage
+        profile_begin(&profile);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (memcmp(digests + i * args->digest_length, target, args->digest_length) == 0)
+            {
+                found = i;
+                break;
+            }
+        }
+        profile_end(&profile, PHASE_MATCH);
+
+        profile.candidates += (found == SIZE_MAX) ? count : found + 1;
+    } while (count == PROFILE_BATCH && found == SIZE_MAX);
+
+    if (found != SIZE_MAX)
+    {
+        printf("\nFound pass : %s\n", candidates[found]);
+    }
+    else
+    {
+        printf("\nNo pass was found.\n");
+    }
+
+    profile_report(&profile, stdout);
+    profile_close(&profile);
+
+    free(candidates);
+    free(lengths);
+    free(digests);
+    fclose(file);
+
+    return (found != SIZE_MAX) ? EXIT_SUCCESS : -1;
+}
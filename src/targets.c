@@ -0,0 +1,600 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "targets.h"
+#include "utils.h"
+
+// Hexadecimal character values, -1 for anything else
+// Built at first use so decoding is a lookup instead of a chain of branches
+static signed char hex_table[256];
+static pthread_once_t hex_table_once = PTHREAD_ONCE_INIT;
+
+static void init_hex_table(void)
+{
+    memset(hex_table, -1, sizeof(hex_table));
+
+    for (int i = 0; i < 10; i++)
+    {
+        hex_table['0' + i] = (signed char)i;
+    }
+    for (int i = 0; i < 6; i++)
+    {
+        hex_table['a' + i] = (signed char)(10 + i);
+        hex_table['A' + i] = (signed char)(10 + i);
+    }
+}
+
+// Reason a hash line was rejected
+typedef enum
+{
+    REJECT_FORMAT,
+    REJECT_LENGTH
+} RejectReason_t;
+
+// Rejected line, kept to be reported in file order after the parallel parse
+typedef struct
+{
+    size_t line_number;         // Local to the chunk until the chunks are joined
+    RejectReason_t reason;
+    const char *text;           // Trimmed line inside the mapping
+    size_t length;
+} Reject_t;
+
+// Digests of one length decoded from a chunk
+typedef struct
+{
+    unsigned char *digests;     // Sorted and deduplicated by sort_chunk
+    size_t count;
+    size_t capacity;
+    size_t duplicates;          // Valid lines removed as duplicates within the chunk
+} ChunkSet_t;
+
+// Parse state of one chunk of the mapped file
+typedef struct
+{
+    const char *start;
+    const char *end;
+    const size_t *digest_lengths; // Accepted digest lengths
+    size_t length_count;
+    ChunkSet_t sets[TARGET_MAX_LENGTHS]; // One per accepted digest length
+    size_t sort_set;            // Set sorted by the next sort_chunk call
+    Reject_t *rejects;
+    size_t reject_count;
+    size_t reject_capacity;
+    size_t lines;               // Lines starting in this chunk
+    size_t total;               // Hash lines (excluding empty lines and comments)
+    bool failed;                // Memory allocation failure
+} Chunk_t;
+
+// Digest length used by compare_digests (qsort has no context argument)
+// Set before the sorting threads start and never changed while they run,
+// so the sets of each digest length are sorted in a pass of their own
+static size_t sort_digest_length;
+
+static int compare_digests(const void *a, const void *b)
+{
+    return memcmp(a, b, sort_digest_length);
+}
+
+static bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Decode 'length' bytes of hex, returns false if any character is not hexadecimal
+static bool decode_hex(const char *hex, unsigned char *digest, size_t length)
+{
+    int invalid = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        int high = hex_table[(unsigned char)hex[i * 2]];
+        int low = hex_table[(unsigned char)hex[i * 2 + 1]];
+        invalid |= high | low; // Negative if either character was invalid
+        digest[i] = (unsigned char)(((unsigned int)high << 4) | ((unsigned int)low & 0x0fU));
+    }
+
+    return invalid >= 0;
+}
+
+static bool add_reject(Chunk_t *chunk, RejectReason_t reason, const char *text, size_t length)
+{
+    if (chunk->reject_count == chunk->reject_capacity)
+    {
+        size_t capacity = chunk->reject_capacity ? chunk->reject_capacity * 2 : 64;
+        Reject_t *rejects = realloc(chunk->rejects, capacity * sizeof(Reject_t));
+        if (rejects == NULL)
+        {
+            return false;
+        }
+        chunk->rejects = rejects;
+        chunk->reject_capacity = capacity;
+    }
+
+    Reject_t *reject = &chunk->rejects[chunk->reject_count++];
+    reject->line_number = chunk->lines;
+    reject->reason = reason;
+    reject->text = text;
+    reject->length = length;
+    return true;
+}
+
+// Parse and decode the hashes of one chunk into the set of their digest length
+static void *parse_chunk(void *arg)
+{
+    Chunk_t *chunk = arg;
+    const char *p = chunk->start;
+
+    while (p < chunk->end)
+    {
+        const char *newline = memchr(p, '\n', (size_t)(chunk->end - p));
+        const char *line_end = newline ? newline : chunk->end;
+        const char *hash = p;
+        chunk->lines++;
+        p = newline ? newline + 1 : chunk->end;
+
+        // Trim surrounding whitespace
+        while (hash < line_end && is_blank(*hash))
+            hash++;
+        while (line_end > hash && is_blank(line_end[-1]))
+            line_end--;
+
+        // Skip empty lines and comments
+        if (hash == line_end || *hash == '#')
+        {
+            continue;
+        }
+
+        chunk->total++;
+        size_t length = (size_t)(line_end - hash);
+        size_t set_index = 0;
+
+        while (set_index < chunk->length_count && length != chunk->digest_lengths[set_index] * 2)
+            set_index++;
+
+        if (set_index == chunk->length_count)
+        {
+            // Keep the same priority as before: bad characters first, then length
+            bool hex = true;
+            for (size_t i = 0; i < length && hex; i++)
+                hex = hex_table[(unsigned char)hash[i]] >= 0;
+
+            if (!add_reject(chunk, hex ? REJECT_LENGTH : REJECT_FORMAT, hash, length))
+                goto fail;
+            continue;
+        }
+
+        ChunkSet_t *set = &chunk->sets[set_index];
+        size_t digest_length = chunk->digest_lengths[set_index];
+
+        if (set->count == set->capacity)
+        {
+            size_t capacity = set->capacity ? set->capacity * 2 : 4096;
+            unsigned char *digests = realloc(set->digests, capacity * digest_length);
+            if (digests == NULL)
+                goto fail;
+            set->digests = digests;
+            set->capacity = capacity;
+        }
+
+        if (!decode_hex(hash, set->digests + set->count * digest_length, digest_length))
+        {
+            if (!add_reject(chunk, REJECT_FORMAT, hash, length))
+                goto fail;
+            continue;
+        }
+
+        set->count++;
+    }
+
+    return NULL;
+
+fail:
+    chunk->failed = true;
+    return NULL;
+}
+
+// Sort one set of a parsed chunk and drop its duplicates, with sort_digest_length set to its digest length
+static void *sort_chunk(void *arg)
+{
+    Chunk_t *chunk = arg;
+    ChunkSet_t *set = &chunk->sets[chunk->sort_set];
+    size_t digest_length = sort_digest_length;
+
+    qsort(set->digests, set->count, digest_length, compare_digests);
+
+    // Drop the duplicates within the chunk while the chunks are still processed in parallel
+    size_t unique = 0;
+    for (size_t i = 0; i < set->count; i++)
+    {
+        unsigned char *digest = set->digests + i * digest_length;
+
+        if (unique > 0 && memcmp(set->digests + (unique - 1) * digest_length, digest, digest_length) == 0)
+            continue;
+
+        if (unique != i)
+            memcpy(set->digests + unique * digest_length, digest, digest_length);
+        unique++;
+    }
+    set->duplicates = set->count - unique;
+    set->count = unique;
+
+    return NULL;
+}
+
+// Run 'work' on every chunk in parallel, the calling thread takes the first one
+static void run_chunks(Chunk_t *chunks, size_t chunk_count, void *(*work)(void *))
+{
+    pthread_t threads[MAX_THREADS];
+    size_t started = 1;
+
+    for (; started < chunk_count; started++)
+    {
+        if (pthread_create(&threads[started], NULL, work, &chunks[started]) != 0)
+            break;
+    }
+    for (size_t i = started; i < chunk_count; i++)
+    {
+        work(&chunks[i]);
+    }
+    work(&chunks[0]);
+    for (size_t i = 1; i < started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// Remaining digests of a sorted chunk during the merge
+typedef struct
+{
+    const unsigned char *head;
+    const unsigned char *end;
+} Run_t;
+
+// Restore the min-heap order of the runs below index 'i', ordered by head digest
+static void sift_down(Run_t *heap, size_t count, size_t i, size_t digest_length)
+{
+    for (;;)
+    {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+
+        if (left < count && memcmp(heap[left].head, heap[smallest].head, digest_length) < 0)
+            smallest = left;
+        if (right < count && memcmp(heap[right].head, heap[smallest].head, digest_length) < 0)
+            smallest = right;
+        if (smallest == i)
+            return;
+
+        Run_t swap = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = swap;
+        i = smallest;
+    }
+}
+
+// Merge one sorted, deduplicated set of every chunk into targets, dropping duplicates across chunks
+// The runs are kept in a min-heap so each output digest costs O(log chunks) comparisons
+static bool merge_chunks(Chunk_t *chunks, size_t chunk_count, size_t set_index, size_t digest_length,
+                         TargetSet_t *targets)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < chunk_count; i++)
+        total += chunks[i].sets[set_index].count;
+
+    targets->digests = malloc(total ? total * digest_length : 1);
+    targets->cracked = calloc(total ? total : 1, sizeof(bool));
+    if (targets->digests == NULL || targets->cracked == NULL)
+    {
+        return false;
+    }
+
+    Run_t heap[MAX_THREADS];
+    size_t runs = 0;
+
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        const ChunkSet_t *set = &chunks[i].sets[set_index];
+        if (set->count == 0)
+            continue;
+
+        heap[runs].head = set->digests;
+        heap[runs].end = set->digests + set->count * digest_length;
+        runs++;
+    }
+
+    for (size_t i = runs / 2; i-- > 0;)
+    {
+        sift_down(heap, runs, i, digest_length);
+    }
+
+    size_t count = 0;
+
+    while (runs > 0)
+    {
+        const unsigned char *smallest = heap[0].head;
+
+        if (count == 0 || memcmp(targets->digests + (count - 1) * digest_length, smallest, digest_length) != 0)
+        {
+            memcpy(targets->digests + count * digest_length, smallest, digest_length);
+            count++;
+        }
+
+        heap[0].head += digest_length;
+        if (heap[0].head == heap[0].end)
+            heap[0] = heap[--runs];
+
+        sift_down(heap, runs, 0, digest_length);
+    }
+
+    targets->digest_length = digest_length;
+    targets->count = count;
+    targets->remaining = count;
+    return true;
+}
+
+// Read everything left on 'fd' into a heap buffer, for inputs that cannot be mapped
+static bool read_fd(int fd, char **buffer, size_t *size)
+{
+    size_t capacity = 1 << 16;
+    size_t used = 0;
+    char *data = malloc(capacity);
+
+    if (data == NULL)
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        if (used == capacity)
+        {
+            char *grown = realloc(data, capacity * 2);
+            if (grown == NULL)
+            {
+                free(data);
+                return false;
+            }
+            data = grown;
+            capacity *= 2;
+        }
+
+        ssize_t n = read(fd, data + used, capacity - used);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            free(data);
+            return false;
+        }
+        if (n == 0)
+            break;
+
+        used += (size_t)n;
+    }
+
+    *buffer = data;
+    *size = used;
+    return true;
+}
+
+// Load, decode, sort and deduplicate every hash of a hash file
+bool load_hash_file(const char *path, size_t digest_length, const char *alg_name,
+                    TargetSet_t *targets, LoadStats_t *stats)
+{
+    return load_hash_file_lengths(path, &digest_length, 1, alg_name, targets, stats);
+}
+
+// Load a hash file mixing several digest lengths, into one target set per length
+bool load_hash_file_lengths(const char *path, const size_t *digest_lengths, size_t length_count,
+                            const char *alg_name, TargetSet_t *targets, LoadStats_t *stats)
+{
+    if (path == NULL || digest_lengths == NULL || targets == NULL || stats == NULL ||
+        length_count == 0 || length_count > TARGET_MAX_LENGTHS)
+    {
+        return false;
+    }
+
+    for (size_t j = 0; j < length_count; j++)
+    {
+        if (digest_lengths[j] == 0)
+        {
+            return false;
+        }
+
+        targets[j].digests = NULL;
+        targets[j].cracked = NULL;
+        targets[j].count = 0;
+        targets[j].remaining = 0;
+        targets[j].digest_length = digest_lengths[j];
+    }
+    stats->total = 0;
+    stats->invalid = 0;
+    stats->duplicates = 0;
+
+    pthread_once(&hex_table_once, init_hex_table);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Error: Cannot open hash file '%s': %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        fprintf(stderr, "Error: Cannot stat hash file '%s': %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    // Regular files are mapped; pipes, process substitutions, /dev/stdin and files
+    // that cannot be mapped are read into a heap buffer parsed the same way
+    size_t size = 0;
+    const char *data = NULL;
+    char *buffer = NULL;
+    bool mapped = false;
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        size = (size_t)st.st_size;
+        void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            data = map;
+            mapped = true;
+            posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+        }
+    }
+
+    if (!mapped)
+    {
+        if (!read_fd(fd, &buffer, &size))
+        {
+            fprintf(stderr, "Error: Cannot read hash file '%s': %s\n", path, strerror(errno));
+            close(fd);
+            return false;
+        }
+        data = buffer;
+    }
+    close(fd);
+
+    // Split the mapping into one chunk per thread, on line boundaries
+    size_t chunk_count = thread_count();
+    if (size / chunk_count < 4096)
+        chunk_count = 1;
+
+    Chunk_t chunks[MAX_THREADS];
+    const char *previous_end = data;
+
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        const char *end = data + size;
+
+        if (i + 1 < chunk_count)
+        {
+            const char *split = data + size / chunk_count * (i + 1);
+            const char *newline = memchr(split - 1, '\n', (size_t)(data + size - split + 1));
+            end = newline ? newline + 1 : data + size;
+        }
+
+        memset(&chunks[i], 0, sizeof(Chunk_t));
+        chunks[i].start = previous_end;
+        chunks[i].end = (end < previous_end) ? previous_end : end;
+        chunks[i].digest_lengths = digest_lengths;
+        chunks[i].length_count = length_count;
+        previous_end = chunks[i].end;
+    }
+
+    // Parse the chunks in parallel, then sort the digests of each length in parallel
+    run_chunks(chunks, chunk_count, parse_chunk);
+
+    for (size_t j = 0; j < length_count; j++)
+    {
+        sort_digest_length = digest_lengths[j];
+        for (size_t i = 0; i < chunk_count; i++)
+            chunks[i].sort_set = j;
+
+        run_chunks(chunks, chunk_count, sort_chunk);
+    }
+
+    // Accepted lengths for reports, e.g. "32", "32 or 40", "32, 40 or 64"
+    char expected[TARGET_MAX_LENGTHS * 24] = "";
+    size_t used = 0;
+    for (size_t j = 0; j < length_count; j++)
+    {
+        const char *separator = (j == 0) ? "" : (j + 1 == length_count) ? " or " : ", ";
+        used += (size_t)snprintf(expected + used, sizeof(expected) - used, "%s%zu", separator, digest_lengths[j] * 2);
+    }
+
+    bool ok = true;
+    size_t valid = 0;
+    size_t line_base = 0;
+
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        if (chunks[i].failed)
+            ok = false;
+
+        // Report rejects in file order with global line numbers
+        for (size_t r = 0; r < chunks[i].reject_count; r++)
+        {
+            const Reject_t *reject = &chunks[i].rejects[r];
+            size_t line_number = line_base + reject->line_number;
+
+            if (reject->reason == REJECT_FORMAT)
+            {
+                fprintf(stderr, "Line %zu: Invalid hash format '%.*s'\n",
+                        line_number, (int)reject->length, reject->text);
+            }
+            else
+            {
+                fprintf(stderr, "Line %zu: Hash length mismatch for algorithm '%s'. Expected %s characters, got %zu\n",
+                        line_number, alg_name, expected, reject->length);
+            }
+        }
+
+        line_base += chunks[i].lines;
+        stats->total += chunks[i].total;
+        stats->invalid += chunks[i].reject_count;
+        for (size_t j = 0; j < length_count; j++)
+            valid += chunks[i].sets[j].count + chunks[i].sets[j].duplicates;
+    }
+
+    for (size_t j = 0; j < length_count && ok; j++)
+    {
+        ok = merge_chunks(chunks, chunk_count, j, digest_lengths[j], &targets[j]);
+    }
+
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        for (size_t j = 0; j < length_count; j++)
+            free(chunks[i].sets[j].digests);
+        free(chunks[i].rejects);
+    }
+
+    if (mapped)
+    {
+        munmap((void *)data, size);
+    }
+    free(buffer);
+
+    if (!ok)
+    {
+        fprintf(stderr, "\nMemory allocation failed while loading '%s'.\n", path);
+        for (size_t j = 0; j < length_count; j++)
+            free_targets(&targets[j]);
+        return false;
+    }
+
+    stats->duplicates = valid;
+    for (size_t j = 0; j < length_count; j++)
+        stats->duplicates -= targets[j].count;
+    return true;
+}
+
+// Release a target set
+void free_targets(TargetSet_t *targets)
+{
+    if (targets == NULL)
+    {
+        return;
+    }
+
+    free(targets->digests);
+    free(targets->cracked);
+    targets->digests = NULL;
+    targets->cracked = NULL;
+    targets->count = 0;
+    targets->remaining = 0;
+}
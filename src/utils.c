@@ -1,7 +1,11 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
+#include <errno.h>
 #include <string.h>
 #include <limits.h>
 #include <ctype.h>
+#include <unistd.h>
 #include <openssl/sha.h>
 
 #include "utils.h"
@@ -36,4 +40,113 @@ char *read_line(FILE *file, char *buffer, int size)
     }
 
     return NULL;
+}
+
+// Load every line of a wordlist into memory
+bool load_wordlist(const char *path, WordList_t *list)
+{
+    if (path == NULL || list == NULL)
+    {
+        return false;
+    }
+
+    list->data = NULL;
+    list->offsets = NULL;
+    list->lengths = NULL;
+    list->count = 0;
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error opening file '%s': %s\n", path, strerror(errno));
+        return false;
+    }
+
+    size_t data_size = 0;
+    size_t data_capacity = 0;
+    size_t capacity = 0;
+    char buffer[MAX_WORD_LENGTH];
+    char *line;
+
+    while ((line = read_line(file, buffer, MAX_WORD_LENGTH)))
+    {
+        size_t length = strlen(line);
+
+        // Grow the word index
+        if (list->count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            size_t *offsets = realloc(list->offsets, capacity * sizeof(size_t));
+            if (offsets == NULL)
+            {
+                goto fail;
+            }
+            list->offsets = offsets;
+
+            size_t *lengths = realloc(list->lengths, capacity * sizeof(size_t));
+            if (lengths == NULL)
+            {
+                goto fail;
+            }
+            list->lengths = lengths;
+        }
+
+        // Grow the word storage
+        if (data_size + length + 1 > data_capacity)
+        {
+            data_capacity = data_capacity ? data_capacity * 2 : 16384;
+            while (data_size + length + 1 > data_capacity)
+                data_capacity *= 2;
+            char *data = realloc(list->data, data_capacity);
+            if (data == NULL)
+            {
+                goto fail;
+            }
+            list->data = data;
+        }
+
+        memcpy(list->data + data_size, line, length + 1);
+        list->offsets[list->count] = data_size;
+        list->lengths[list->count] = length;
+        list->count++;
+        data_size += length + 1;
+    }
+
+    fclose(file);
+    return true;
+
+fail:
+    fprintf(stderr, "\nMemory allocation failed while loading '%s'.\n", path);
+    fclose(file);
+    free_wordlist(list);
+    return false;
+}
+
+// Release a wordlist loaded with load_wordlist
+void free_wordlist(WordList_t *list)
+{
+    if (list == NULL)
+    {
+        return;
+    }
+
+    free(list->data);
+    free(list->offsets);
+    free(list->lengths);
+    list->data = NULL;
+    list->offsets = NULL;
+    list->lengths = NULL;
+    list->count = 0;
+}
+
+// Number of worker threads to use
+size_t thread_count(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (cpus < 1)
+        return 1;
+    if (cpus > MAX_THREADS)
+        return MAX_THREADS;
+    return (size_t)cpus;
 }
\ No newline at end of file